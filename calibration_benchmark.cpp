@@ -0,0 +1,393 @@
+/**
+  @file calibration_benchmark.cpp
+  @brief A calibration solver benchmark using synthetic chessboard observations:
+  runtime and parameter error vs number of views, board size and distortion model
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "camera.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+ * @brief The BenchmarkSettings struct to keep command line settings
+ */
+struct BenchmarkSettings {
+    cv::Size image_size = cv::Size(1920, 1080);
+    cv::Size board = cv::Size(6, 9);
+    float square = 0.0268f;
+    double noise = 0.2;
+    int repeats = 3;
+    uint64_t seed = 1;
+    std::vector<int> views = {5, 10, 15, 20, 30, 40};
+    bool detection = true;
+};
+
+/**
+ * @brief The BenchmarkModel struct to describe the benchmarked distortion model,
+ * calibrated with the flags the camera uses for it (get_distortion_model_flags())
+ */
+struct BenchmarkModel {
+    std::string name;
+    camera_ns::DistortionModel model;
+    std::vector<double> ground_truth;
+};
+
+/**
+ * @brief The SolverResult struct to keep averaged results of single configuration
+ */
+struct SolverResult {
+    double views_used = 0.0;
+    double time_ms = 0.0;
+    double rms = 0.0;
+    double focal_error = 0.0;
+    double principal_point_error = 0.0;
+    double dist_error = 0.0;
+};
+
+/**
+ * @brief: Parses WxH string
+ */
+static cv::Size parse_size(const std::string& text)
+{
+    int width = 0;
+    int height = 0;
+    char separator = 0;
+    std::istringstream stream(text);
+    stream >> width >> separator >> height;
+    return cv::Size(width, height);
+}
+
+/**
+ * @brief: Parses comma separated list of integers
+ */
+static std::vector<int> parse_list(const std::string& text)
+{
+    std::vector<int> values;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::atoi(item.c_str()));
+    }
+    return values;
+}
+
+/**
+ * @brief: Reads command line settings
+ * @return: false when arguments are wrong
+ */
+static bool parse_settings(int argc, char** argv, BenchmarkSettings& settings)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--no-detection") {
+            settings.detection = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (key == "--resolution") {
+            settings.image_size = parse_size(value);
+        } else if (key == "--board") {
+            settings.board = parse_size(value);
+        } else if (key == "--square") {
+            settings.square = static_cast<float>(std::atof(value.c_str()));
+        } else if (key == "--noise") {
+            settings.noise = std::atof(value.c_str());
+        } else if (key == "--repeats") {
+            settings.repeats = std::atoi(value.c_str());
+        } else if (key == "--seed") {
+            settings.seed = static_cast<uint64_t>(std::atoll(value.c_str()));
+        } else if (key == "--views") {
+            settings.views = parse_list(value);
+        } else {
+            return false;
+        }
+    }
+    return settings.image_size.area() > 0 and settings.board.area() > 0
+            and settings.square > 0.0f and settings.repeats > 0 and settings.views.empty() == false;
+}
+
+/**
+ * @brief: Returns ground truth camera matrix for the image size
+ */
+static cv::Mat make_ground_truth_camera_matrix(cv::Size image_size)
+{
+    cv::Mat camera_matrix = cv::Mat::eye(3, 3, CV_64F);
+    camera_matrix.at<double>(0, 0) = 0.9 * image_size.width;
+    camera_matrix.at<double>(1, 1) = 0.9 * image_size.width;
+    camera_matrix.at<double>(0, 2) = 0.5 * image_size.width - 0.5;
+    camera_matrix.at<double>(1, 2) = 0.5 * image_size.height - 0.5;
+    return camera_matrix;
+}
+
+/**
+ * @brief: Returns the benchmarked distortion models
+ */
+static std::vector<BenchmarkModel> make_models()
+{
+    std::vector<BenchmarkModel> models;
+    models.push_back({"radial2", camera_ns::DistortionModel::radial2,
+                      {-0.28, 0.09, 0.0, 0.0, 0.0}});
+    models.push_back({"radial_tangential", camera_ns::DistortionModel::radial_tangential,
+                      {-0.28, 0.09, 0.0008, -0.0005, 0.0}});
+    models.push_back({"radial3_tangential", camera_ns::DistortionModel::radial3_tangential,
+                      {-0.28, 0.09, 0.0008, -0.0005, -0.01}});
+    models.push_back({"rational", camera_ns::DistortionModel::rational,
+                      {-0.28, 0.09, 0.0008, -0.0005, -0.01, 0.02, -0.01, 0.005}});
+    models.push_back({"thin_prism", camera_ns::DistortionModel::thin_prism,
+                      {-0.28, 0.09, 0.0008, -0.0005, -0.01, 0.02, -0.01, 0.005,
+                       0.001, -0.0005, 0.0007, 0.0002}});
+    return models;
+}
+
+/**
+ * @brief: Draws a random board pose which keeps the whole board inside the image
+ * @param rvec an output rotation vector
+ * @param tvec an output translation vector
+ * @param image_points projected corners with noise
+ * @return: false when no valid pose was found
+ */
+static bool make_random_view(const std::vector<cv::Point3f>& board_points, const BenchmarkSettings& settings,
+                             const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs, cv::RNG& rng,
+                             std::vector<cv::Point2f>& image_points, cv::Mat& rvec, cv::Mat& tvec)
+{
+    const double focal = camera_matrix.at<double>(0, 0);
+    const double board_width = (settings.board.width - 1) * settings.square;
+    const double board_height = (settings.board.height - 1) * settings.square;
+    const double max_angle = 35.0 * CV_PI / 180.0;
+
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        /// board covers 30-70 % of the image width
+        const double coverage = rng.uniform(0.3, 0.7);
+        const double z = focal * board_width / (coverage * settings.image_size.width);
+        const double x = rng.uniform(-0.25, 0.25) * z * settings.image_size.width / focal;
+        const double y = rng.uniform(-0.25, 0.25) * z * settings.image_size.height / focal;
+
+        rvec = (cv::Mat_<double>(3, 1) << rng.uniform(-max_angle, max_angle),
+                rng.uniform(-max_angle, max_angle), rng.uniform(-CV_PI, CV_PI));
+        cv::Mat rotation;
+        cv::Rodrigues(rvec, rotation);
+        cv::Mat center = (cv::Mat_<double>(3, 1) << 0.5 * board_width, 0.5 * board_height, 0.0);
+        cv::Mat position = (cv::Mat_<double>(3, 1) << x, y, z);
+        tvec = position - rotation * center;
+
+        cv::projectPoints(board_points, rvec, tvec, camera_matrix, dist_coeffs, image_points);
+        bool inside = true;
+        for (size_t i = 0; i < image_points.size(); ++i) {
+            cv::Point2f& p = image_points[i];
+            p.x += static_cast<float>(rng.gaussian(settings.noise));
+            p.y += static_cast<float>(rng.gaussian(settings.noise));
+            if (p.x < 0 or p.y < 0 or p.x > settings.image_size.width - 1
+                    or p.y > settings.image_size.height - 1) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief: Times the solver for single model and number of views
+ */
+static SolverResult run_solver(const BenchmarkSettings& settings, const BenchmarkModel& model,
+                               int views, cv::RNG& rng)
+{
+    SolverResult result;
+    cv::Mat camera_matrix = make_ground_truth_camera_matrix(settings.image_size);
+    cv::Mat dist_coeffs = cv::Mat(model.ground_truth, true);
+
+    for (int repeat = 0; repeat < settings.repeats; ++repeat) {
+        camera_ns::Camera cam;
+        cam.set_chessboard_dimensions(static_cast<uint8_t>(settings.board.width),
+                                      static_cast<uint8_t>(settings.board.height));
+        cam.set_chessboard_square_dimension(settings.square);
+        cam.set_distortion_model(model.model);
+        std::vector<cv::Point3f> board_points = cam.get_known_board_positions();
+
+        /// a view without a valid pose is drawn again, the number of views used is reported
+        std::vector<std::vector<cv::Point2f>> image_points;
+        for (int attempt = 0; attempt < 10 * views and static_cast<int>(image_points.size()) < views; ++attempt) {
+            std::vector<cv::Point2f> points;
+            cv::Mat rvec, tvec;
+            if (make_random_view(board_points, settings, camera_matrix, dist_coeffs, rng,
+                                 points, rvec, tvec)) {
+                image_points.push_back(points);
+            }
+        }
+
+        bench_clock::time_point start = bench_clock::now();
+        double rms = cam.calibrate_from_image_points(image_points, settings.image_size);
+        bench_clock::time_point stop = bench_clock::now();
+
+        cv::Mat estimated = cam.get_camera_matrix();
+        cv::Mat estimated_dist = cam.get_dist_coefs().reshape(1, 1);
+        double dist_error = 0.0;
+        for (size_t i = 0; i < model.ground_truth.size(); ++i) {
+            double value = static_cast<int>(i) < static_cast<int>(estimated_dist.total())
+                    ? estimated_dist.at<double>(static_cast<int>(i)) : 0.0;
+            dist_error = std::max(dist_error, std::abs(value - model.ground_truth[i]));
+        }
+        result.views_used += static_cast<double>(image_points.size());
+        result.time_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+        result.rms += rms;
+        result.focal_error += std::abs(estimated.at<double>(0, 0) - camera_matrix.at<double>(0, 0));
+        result.principal_point_error += std::hypot(
+                    estimated.at<double>(0, 2) - camera_matrix.at<double>(0, 2),
+                    estimated.at<double>(1, 2) - camera_matrix.at<double>(1, 2));
+        result.dist_error += dist_error;
+    }
+    const double repeats = static_cast<double>(settings.repeats);
+    result.views_used /= repeats;
+    result.time_ms /= repeats;
+    result.rms /= repeats;
+    result.focal_error /= repeats;
+    result.principal_point_error /= repeats;
+    result.dist_error /= repeats;
+    return result;
+}
+
+/**
+ * @brief: Renders the chessboard seen from a view, distortion is not applied
+ */
+static cv::Mat render_view(const BenchmarkSettings& settings, const cv::Mat& camera_matrix,
+                           const cv::Mat& rvec, const cv::Mat& tvec)
+{
+    /// board image: one square is 32 px, one square of white margin around inner corners
+    const int square_px = 32;
+    const int squares_x = settings.board.width + 1;
+    const int squares_y = settings.board.height + 1;
+    cv::Mat board(squares_y * square_px + 2 * square_px, squares_x * square_px + 2 * square_px,
+                  CV_8UC1, cv::Scalar(255));
+    for (int sy = 0; sy < squares_y; ++sy) {
+        for (int sx = 0; sx < squares_x; ++sx) {
+            if ((sx + sy) % 2 == 0) {
+                cv::rectangle(board, cv::Rect((sx + 1) * square_px, (sy + 1) * square_px,
+                                              square_px, square_px), cv::Scalar(0), -1);
+            }
+        }
+    }
+    /// board pixels to board plane [m]; the first inner corner is at (0, 0)
+    const double meters_per_px = settings.square / square_px;
+    cv::Mat board_to_plane = (cv::Mat_<double>(3, 3) << meters_per_px, 0.0, -2.0 * settings.square,
+                              0.0, meters_per_px, -2.0 * settings.square, 0.0, 0.0, 1.0);
+    cv::Mat rotation;
+    cv::Rodrigues(rvec, rotation);
+    cv::Mat plane_to_image = (cv::Mat_<double>(3, 3) <<
+                              rotation.at<double>(0, 0), rotation.at<double>(0, 1), tvec.at<double>(0),
+                              rotation.at<double>(1, 0), rotation.at<double>(1, 1), tvec.at<double>(1),
+                              rotation.at<double>(2, 0), rotation.at<double>(2, 1), tvec.at<double>(2));
+    cv::Mat homography = camera_matrix * plane_to_image * board_to_plane;
+    cv::Mat image;
+    cv::warpPerspective(board, image, homography, settings.image_size, cv::INTER_LINEAR,
+                        cv::BORDER_CONSTANT, cv::Scalar(128));
+    cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
+    return image;
+}
+
+/**
+ * @brief: Times chessboard detection on rendered views at the sensor resolution
+ */
+static void run_detection(const BenchmarkSettings& settings, cv::RNG& rng)
+{
+    camera_ns::Camera cam;
+    cam.set_chessboard_dimensions(static_cast<uint8_t>(settings.board.width),
+                                  static_cast<uint8_t>(settings.board.height));
+    cam.set_chessboard_square_dimension(settings.square);
+
+    const int positions_repeats = 1000;
+    bench_clock::time_point start = bench_clock::now();
+    std::vector<cv::Point3f> board_points;
+    for (int i = 0; i < positions_repeats; ++i) {
+        board_points = cam.get_known_board_positions();
+    }
+    bench_clock::time_point stop = bench_clock::now();
+    std::cout << "create_known_board_positions: "
+              << std::chrono::duration<double, std::micro>(stop - start).count() / positions_repeats
+              << " us" << std::endl;
+
+    cv::Mat camera_matrix = make_ground_truth_camera_matrix(settings.image_size);
+    cv::Mat no_distortion = cv::Mat::zeros(5, 1, CV_64F);
+    double total_ms = 0.0;
+    int detected = 0;
+    int images = 0;
+    const int requested_images = 10;
+    for (int attempt = 0; attempt < 10 * requested_images and images < requested_images; ++attempt) {
+        std::vector<cv::Point2f> points;
+        cv::Mat rvec, tvec;
+        if (make_random_view(board_points, settings, camera_matrix, no_distortion, rng,
+                             points, rvec, tvec) == false) {
+            continue;
+        }
+        ++images;
+        cv::Mat image = render_view(settings, camera_matrix, rvec, tvec);
+        std::vector<cv::Point2f> found_points;
+        start = bench_clock::now();
+        bool found = cv::findChessboardCorners(image, settings.board, found_points,
+                                               CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_NORMALIZE_IMAGE);
+        stop = bench_clock::now();
+        total_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+        detected += found ? 1 : 0;
+    }
+    std::cout << "findChessboardCorners " << settings.image_size.width << "x"
+              << settings.image_size.height << ": " << total_ms / std::max(images, 1) << " ms/image, found "
+              << detected << "/" << images << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    if (parse_settings(argc, argv, settings) == false) {
+        std::cout << "Usage: " << argv[0] << " [--resolution WxH] [--board CxR] [--square m]"
+                  << " [--noise px] [--repeats n] [--seed n] [--views 5,10,20] [--no-detection]"
+                  << std::endl;
+        return 1;
+    }
+    cv::RNG rng(settings.seed);
+
+    std::cout << "resolution " << settings.image_size.width << "x" << settings.image_size.height
+              << ", board " << settings.board.width << "x" << settings.board.height
+              << ", noise " << settings.noise << " px, repeats " << settings.repeats << std::endl;
+    if (settings.detection) {
+        run_detection(settings, rng);
+    }
+
+    std::cout << "model,views,views_used,time_ms,rms_px,focal_error_px,principal_point_error_px,max_dist_error"
+              << std::endl;
+    std::vector<BenchmarkModel> models = make_models();
+    for (size_t m = 0; m < models.size(); ++m) {
+        for (size_t v = 0; v < settings.views.size(); ++v) {
+            SolverResult result;
+            try {
+                result = run_solver(settings, models[m], settings.views[v], rng);
+            } catch (const camera_ns::ExceptionMessage& em) {
+                std::cout << models[m].name << "," << settings.views[v] << ",error: " << em.msg << std::endl;
+                continue;
+            }
+            std::cout << models[m].name << "," << settings.views[v] << "," << result.views_used << ","
+                      << result.time_ms << "," << result.rms << ","
+                      << result.focal_error << "," << result.principal_point_error << ","
+                      << result.dist_error << std::endl;
+        }
+    }
+    return 0;
+}
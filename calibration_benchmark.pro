@@ -0,0 +1,39 @@
+TEMPLATE = app
+TARGET = calibration_benchmark
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+SOURCES += \
+        calibration_benchmark.cpp \
+    calibration_data.cpp \
+    calibration_model.cpp \
+    calibration_reloader.cpp \
+    camera.cpp \
+    coarse_remap.cpp \
+    distortion_model.cpp \
+    frame_source.cpp \
+    remap_kernels.cpp \
+    shm_frame_ring.cpp
+
+INCLUDEPATH += /usr/local/include/opencv
+
+LIBS += -L/usr/local/lib/
+LIBS += -lopencv_core
+LIBS += -lopencv_imgproc
+LIBS += -lopencv_highgui
+LIBS += -lopencv_videoio
+LIBS += -lopencv_calib3d
+LIBS += -lrt
+LIBS += -lpthread
+
+HEADERS += \
+    calibration_data.h \
+    calibration_model.h \
+    calibration_reloader.h \
+    camera.h \
+    coarse_remap.h \
+    distortion_model.h \
+    frame_source.h \
+    remap_kernels.h \
+    shm_frame_ring.h
@@ -0,0 +1,182 @@
+/**
+  @file calibration_data.cpp
+  @brief A definitions of calibration data, its file format and remap maps building
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <opencv2/calib3d.hpp>
+#include "calibration_data.h"
+#include "distortion_model.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: Reads a matrix of doubles stored as rows, columns and values
+ * @return: false when the stream ended or is malformed
+ */
+static bool read_matrix(std::istream& in_stream, cv::Mat& matrix)
+{
+    int rows = 0;
+    int columns = 0;
+    if (!(in_stream >> rows >> columns) or rows <= 0 or columns <= 0) {
+        return false;
+    }
+    matrix = cv::Mat::zeros(rows, columns, CV_64F);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            if (!(in_stream >> matrix.at<double>(r, c))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief: Writes a matrix of doubles as rows, columns and values
+ */
+static void write_matrix(std::ostream& out_stream, const cv::Mat& matrix)
+{
+    out_stream << matrix.rows << std::endl;
+    out_stream << matrix.cols << std::endl;
+    for (int r = 0; r < matrix.rows; r++) {
+        for (int c = 0; c < matrix.cols; c++) {
+            out_stream << matrix.at<double>(r, c) << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief: Reads calibration data: camera matrix, dist coefficients and
+ * calibration resolution (missing in files saved by older versions)
+ * @param in_stream a stream to read from
+ * @param data read calibration data, untouched on failure
+ * @return: true when camera matrix and dist coefficients were read
+ */
+bool camera_ns::read_calibration_data(std::istream &in_stream, CalibrationData &data)
+{
+    CalibrationData read;
+    if (read_matrix(in_stream, read.cam_matrix) == false
+            or read_matrix(in_stream, read.dist_coeffs) == false) {
+        return false;
+    }
+    int width = 0;
+    int height = 0;
+    if (in_stream >> width >> height) {
+        read.frame_size = cv::Size(width, height);
+    }
+    data = read;
+    return true;
+}
+
+/**
+ * @brief: Writes calibration data in the format read by read_calibration_data
+ * @param out_stream a stream to write to
+ * @param data calibration data
+ * @return: true when the stream is still good
+ */
+bool camera_ns::write_calibration_data(std::ostream &out_stream, const CalibrationData &data)
+{
+    write_matrix(out_stream, data.cam_matrix);
+    write_matrix(out_stream, data.dist_coeffs);
+    out_stream << data.frame_size.width << std::endl;
+    out_stream << data.frame_size.height << std::endl;
+    return static_cast<bool>(out_stream);
+}
+
+/**
+ * @brief: Reads calibration data from a file
+ * @param file_name a calibration file name
+ * @param data read calibration data, untouched on failure
+ * @return: false when the file cannot be opened or is malformed
+ */
+bool camera_ns::read_calibration_file(const std::string &file_name, CalibrationData &data)
+{
+    std::ifstream in_stream(file_name);
+    if (!in_stream) {
+        return false;
+    }
+    return read_calibration_data(in_stream, data);
+}
+
+/**
+ * @brief: Scales the camera matrix to a capture resolution
+ * @param data calibration data
+ * @param arg_size the capture resolution
+ * @param camera_matrix camera matrix valid for arg_size
+ * @return: false when the aspect ratio of arg_size differs from the calibration one
+ */
+bool camera_ns::scale_camera_matrix(const CalibrationData &data, cv::Size arg_size,
+                                    cv::Mat &camera_matrix)
+{
+    if (data.frame_size.area() == 0 or arg_size == data.frame_size) {
+        camera_matrix = data.cam_matrix;
+        return true;
+    }
+    double scale_x = static_cast<double>(arg_size.width) / data.frame_size.width;
+    double scale_y = static_cast<double>(arg_size.height) / data.frame_size.height;
+    if (std::abs(scale_x - scale_y) > 1e-3 * std::max(scale_x, scale_y)) {
+        return false;
+    }
+    /// pixel centers are kept aligned: x' = (x + 0.5) * scale - 0.5
+    cv::Mat scaled = data.cam_matrix.clone();
+    scaled.at<double>(0, 0) *= scale_x;
+    scaled.at<double>(0, 1) *= scale_x;
+    scaled.at<double>(0, 2) = (data.cam_matrix.at<double>(0, 2) + 0.5) * scale_x - 0.5;
+    scaled.at<double>(1, 1) *= scale_y;
+    scaled.at<double>(1, 2) = (data.cam_matrix.at<double>(1, 2) + 0.5) * scale_y - 0.5;
+    camera_matrix = scaled;
+    return true;
+}
+
+/**
+ * @brief: Returns the camera matrix of compensated image
+ * @param camera_matrix camera matrix valid for arg_size
+ * @param dist_coeffs dist coefficients
+ * @param arg_size the capture resolution
+ * @return: optimal new camera matrix keeping all source pixels
+ */
+cv::Mat camera_ns::get_new_camera_matrix(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                         cv::Size arg_size)
+{
+    return getOptimalNewCameraMatrix(camera_matrix, dist_coeffs, arg_size, 1, arg_size, nullptr);
+}
+
+/**
+ * @brief: Builds dense fixed-point remap maps
+ * @param camera_matrix camera matrix valid for arg_size
+ * @param dist_coeffs dist coefficients
+ * @param arg_size the capture resolution
+ * @param maps maps to fill
+ */
+void camera_ns::build_dense_remap_maps(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                       cv::Size arg_size, RemapMaps &maps)
+{
+    build_undistort_maps(camera_matrix, dist_coeffs,
+                         get_new_camera_matrix(camera_matrix, dist_coeffs, arg_size),
+                         arg_size, CV_16SC2, maps.map1, maps.map2);
+}
+
+/**
+ * @brief: Builds compact coarse-grid remap map
+ * @param camera_matrix camera matrix valid for arg_size
+ * @param dist_coeffs dist coefficients
+ * @param arg_size the capture resolution
+ * @param grid_step a distance between grid nodes [px]
+ * @param interpolation an interpolation between grid nodes
+ * @param maps maps to fill
+ */
+void camera_ns::build_compact_remap_map(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                        cv::Size arg_size, int grid_step,
+                                        GridInterpolation interpolation, RemapMaps &maps)
+{
+    maps.compact.build(camera_matrix, dist_coeffs,
+                       get_new_camera_matrix(camera_matrix, dist_coeffs, arg_size),
+                       arg_size, grid_step, interpolation);
+}
@@ -0,0 +1,54 @@
+/**
+  @file calibration_data.h
+  @brief A declarations of calibration data, its file format and remap maps building
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef CALIBRATION_DATA_H
+#define CALIBRATION_DATA_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <opencv2/core.hpp>
+#include "coarse_remap.h"
+
+namespace camera_ns {
+    /**
+     * @brief The CalibrationData struct to keep camera calibration results
+     * and the resolution they were computed at (empty when unknown)
+     */
+    struct CalibrationData {
+        cv::Mat cam_matrix;
+        cv::Mat dist_coeffs;
+        cv::Size frame_size;
+    };
+
+    /**
+     * @brief The RemapMaps struct to keep remap maps built
+     * for single capture resolution, dense and compact maps
+     * are built only when used
+     */
+    struct RemapMaps {
+        cv::Mat map1;
+        cv::Mat map2;
+        CoarseRemapMap compact;
+    };
+
+    bool read_calibration_data(std::istream& in_stream, CalibrationData& data);
+    bool write_calibration_data(std::ostream& out_stream, const CalibrationData& data);
+    bool read_calibration_file(const std::string& file_name, CalibrationData& data);
+
+    bool scale_camera_matrix(const CalibrationData& data, cv::Size arg_size, cv::Mat& camera_matrix);
+    cv::Mat get_new_camera_matrix(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                                  cv::Size arg_size);
+    void build_dense_remap_maps(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                                cv::Size arg_size, RemapMaps& maps);
+    void build_compact_remap_map(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                                 cv::Size arg_size, int grid_step,
+                                 GridInterpolation interpolation, RemapMaps& maps);
+}
+
+#endif // CALIBRATION_DATA_H
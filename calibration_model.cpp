@@ -0,0 +1,366 @@
+/**
+  @file calibration_model.cpp
+  @brief A definitions of immutable calibration model shared by cameras, with its remap maps
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include "calibration_model.h"
+
+
+using namespace camera_ns;
+
+/// a number of band heights with source row indexes kept per capture resolution
+static const size_t max_row_index_heights = 4;
+
+/**
+ * @brief The ModelRegistry struct keeps models in use, indexed by data hash.
+ * Models are held weakly, a model is released with the last camera using it.
+ */
+struct ModelRegistry {
+    std::mutex mutex;
+    std::multimap<uint64_t, std::weak_ptr<const CalibrationModel>> models;
+};
+
+/**
+ * @brief: Returns the process-wide model registry
+ */
+static ModelRegistry& get_registry()
+{
+    static ModelRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief: Returns a cached value, builds it when missing. The cache keeps a shared
+ * future per key: the first caller inserts it under the mutex and builds the value
+ * with the mutex unlocked, other callers of the key wait for the future.
+ * A failed build is removed from the cache and rethrown to every waiting caller.
+ * @param mutex the cache mutex
+ * @param cache the cache
+ * @param key the value key
+ * @param build the value builder, called without the mutex
+ * @return: the value
+ */
+template <typename Key, typename Value, typename Build>
+static std::shared_ptr<const Value> get_or_build(std::mutex& mutex,
+                                                 std::map<Key, std::shared_future<std::shared_ptr<const Value>>>& cache,
+                                                 const Key& key, Build build)
+{
+    std::promise<std::shared_ptr<const Value>> promise;
+    std::shared_future<std::shared_ptr<const Value>> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            future = it->second;
+        } else {
+            cache.insert(std::make_pair(key, promise.get_future().share()));
+        }
+    }
+    if (future.valid()) {
+        return future.get();
+    }
+    try {
+        std::shared_ptr<const Value> value = build();
+        promise.set_value(value);
+        return value;
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+/**
+ * @brief: Check if a cached value is built
+ */
+template <typename Value>
+static bool is_built(const std::shared_future<std::shared_ptr<const Value>>& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/**
+ * @brief: Adds bytes to FNV-1a hash
+ */
+static uint64_t hash_bytes(uint64_t hash, const void* bytes, size_t count)
+{
+    const uint64_t fnv_prime = 1099511628211ULL;
+    const unsigned char* data = static_cast<const unsigned char*>(bytes);
+    for (size_t i = 0; i < count; ++i) {
+        hash = (hash ^ data[i]) * fnv_prime;
+    }
+    return hash;
+}
+
+/**
+ * @brief: Adds a matrix (type, size and values) to FNV-1a hash
+ */
+static uint64_t hash_matrix(uint64_t hash, const cv::Mat& matrix)
+{
+    const int header[3] = {matrix.type(), matrix.rows, matrix.cols};
+    hash = hash_bytes(hash, header, sizeof(header));
+    const size_t row_bytes = static_cast<size_t>(matrix.cols) * matrix.elemSize();
+    for (int r = 0; r < matrix.rows; ++r) {
+        hash = hash_bytes(hash, matrix.ptr(r), row_bytes);
+    }
+    return hash;
+}
+
+/**
+ * @brief: Check if matrices have the same type, size and values
+ */
+static bool same_matrix(const cv::Mat& a, const cv::Mat& b)
+{
+    if (a.type() != b.type() or a.size() != b.size()) {
+        return false;
+    }
+    return a.empty() or cv::norm(a, b, cv::NORM_INF) == 0.0;
+}
+
+/**
+ * @brief: Returns the content hash of calibration data
+ * @param data calibration data
+ * @return: FNV-1a hash of camera matrix, dist coefficients and calibration resolution
+ */
+uint64_t camera_ns::hash_calibration_data(const CalibrationData &data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hash_matrix(hash, data.cam_matrix);
+    hash = hash_matrix(hash, data.dist_coeffs);
+    const int frame_size[2] = {data.frame_size.width, data.frame_size.height};
+    return hash_bytes(hash, frame_size, sizeof(frame_size));
+}
+
+/**
+ * @brief: A constructor, the data is copied so callers cannot modify the model
+ * @param arg_data calibration data
+ * @param arg_hash the content hash of arg_data
+ */
+CalibrationModel::CalibrationModel(const CalibrationData &arg_data, uint64_t arg_hash)
+    : hash(arg_hash)
+{
+    data.cam_matrix = arg_data.cam_matrix.clone();
+    data.dist_coeffs = arg_data.dist_coeffs.clone();
+    data.frame_size = arg_data.frame_size;
+}
+
+/**
+ * @brief: Returns the model of calibration data, the model is shared with
+ * every other user of the same data in the process
+ * @param data calibration data
+ * @return: calibration model
+ */
+std::shared_ptr<const CalibrationModel> CalibrationModel::get(const CalibrationData &data)
+{
+    const uint64_t data_hash = hash_calibration_data(data);
+    ModelRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto range = registry.models.equal_range(data_hash);
+    for (auto it = range.first; it != range.second;) {
+        std::shared_ptr<const CalibrationModel> model = it->second.lock();
+        if (!model) {
+            it = registry.models.erase(it);
+        } else if (model->has_same_data(data)) {
+            return model;
+        } else {
+            ++it;
+        }
+    }
+    std::shared_ptr<const CalibrationModel> model(new CalibrationModel(data, data_hash));
+    registry.models.insert(std::make_pair(data_hash, std::weak_ptr<const CalibrationModel>(model)));
+    return model;
+}
+
+/**
+ * @brief: Returns the number of models in use, released models are dropped
+ * @return: registry size
+ */
+size_t CalibrationModel::get_registry_size()
+{
+    ModelRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto it = registry.models.begin(); it != registry.models.end();) {
+        if (it->second.expired()) {
+            it = registry.models.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return registry.models.size();
+}
+
+/**
+ * @brief: Returns the calibration data
+ * @return: camera matrix, dist coefficients and calibration resolution
+ */
+const CalibrationData &CalibrationModel::get_data() const
+{
+    return data;
+}
+
+/**
+ * @brief: Returns the content hash of the calibration data
+ * @return: hash
+ */
+uint64_t CalibrationModel::get_hash() const
+{
+    return hash;
+}
+
+/**
+ * @brief: Returns camera matrix scaled to a capture resolution
+ * @param arg_size the capture resolution
+ * @param camera_matrix camera matrix valid for arg_size
+ * @return: false when the aspect ratio of arg_size differs from the calibration one
+ */
+bool CalibrationModel::get_camera_matrix_for_size(cv::Size arg_size, cv::Mat &camera_matrix) const
+{
+    return scale_camera_matrix(data, arg_size, camera_matrix);
+}
+
+/**
+ * @brief: Returns dense fixed-point remap maps of a capture resolution, built on
+ * first use; other threads asking for the same maps wait for the build instead of
+ * repeating it, maps of other resolutions are not blocked by the build
+ * @param arg_size the capture resolution
+ * @param map1 the first map (CV_16SC2), shared and must not be modified
+ * @param map2 the second map (CV_16UC1), shared and must not be modified
+ * @return: false when the aspect ratio of arg_size differs from the calibration one
+ */
+bool CalibrationModel::get_dense_maps(cv::Size arg_size, cv::Mat &map1, cv::Mat &map2) const
+{
+    std::shared_ptr<const RemapMaps> maps = find_dense_maps(arg_size);
+    if (!maps) {
+        return false;
+    }
+    map1 = maps->map1;
+    map2 = maps->map2;
+    return true;
+}
+
+/**
+ * @brief: Returns the source row index of dense remap maps of a capture resolution,
+ * the maps and the index are built on first use. Indexes of up to max_row_index_heights
+ * band heights are kept per resolution, so cameras sharing the model with different
+ * band heights reuse their indexes while the cache stays bounded.
+ * @param arg_size the capture resolution
+ * @param band_rows a number of destination rows in a band, limited to [1, arg_size.height]
+ * @return: source row index for linear sampling, empty pointer when the aspect
+ * ratio of arg_size differs from the calibration one
+ */
+std::shared_ptr<const SourceRowIndex> CalibrationModel::get_source_row_index(cv::Size arg_size,
+                                                                             int band_rows) const
+{
+    std::shared_ptr<const RemapMaps> maps = find_dense_maps(arg_size);
+    if (!maps) {
+        return std::shared_ptr<const SourceRowIndex>();
+    }
+    band_rows = std::max(1, std::min(band_rows, arg_size.height));
+    std::shared_ptr<const SourceRowIndex> row_index =
+            get_or_build(mutex, row_indexes, std::make_tuple(arg_size.width, arg_size.height, band_rows), [&]() {
+        std::shared_ptr<SourceRowIndex> built = std::make_shared<SourceRowIndex>();
+        build_source_row_index(FixedPointMapSampler(maps->map1, maps->map2), arg_size.height, band_rows,
+                               RemapInterpolation::linear, *built);
+        return std::shared_ptr<const SourceRowIndex>(built);
+    });
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto first = row_indexes.lower_bound(std::make_tuple(arg_size.width, arg_size.height, 0));
+    auto last = first;
+    size_t heights = 0;
+    while (last != row_indexes.end() and std::get<0>(last->first) == arg_size.width
+           and std::get<1>(last->first) == arg_size.height) {
+        ++last;
+        ++heights;
+    }
+    /// over the limit, indexes of other band heights are dropped, from the lowest one
+    for (auto it = first; heights > max_row_index_heights and it != last;) {
+        if (std::get<2>(it->first) != band_rows) {
+            it = row_indexes.erase(it);
+            --heights;
+        } else {
+            ++it;
+        }
+    }
+    return row_index;
+}
+
+/**
+ * @brief: Returns compact remap map of a capture resolution and grid settings, built on first use
+ * @param arg_size the capture resolution
+ * @param grid_step a distance between grid nodes [px]
+ * @param interpolation an interpolation between grid nodes
+ * @return: compact remap map, empty pointer when the aspect ratio of arg_size
+ * differs from the calibration one
+ */
+std::shared_ptr<const CoarseRemapMap> CalibrationModel::get_compact_map(cv::Size arg_size, int grid_step,
+                                                                        GridInterpolation interpolation) const
+{
+    cv::Mat camera_matrix;
+    if (scale_camera_matrix(data, arg_size, camera_matrix) == false) {
+        return std::shared_ptr<const CoarseRemapMap>();
+    }
+    return get_or_build(mutex, compact_maps,
+                        std::make_tuple(arg_size.width, arg_size.height, grid_step, interpolation),
+                        [&]() {
+        RemapMaps maps;
+        build_compact_remap_map(camera_matrix, data.dist_coeffs, arg_size, grid_step, interpolation, maps);
+        return std::make_shared<const CoarseRemapMap>(maps.compact);
+    });
+}
+
+/**
+ * @brief: Returns number of capture resolutions with built maps
+ * @return: number of resolutions
+ */
+size_t CalibrationModel::get_cached_sizes_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::set<SizeKey> sizes;
+    for (auto it = dense_maps.begin(); it != dense_maps.end(); ++it) {
+        if (is_built(it->second)) {
+            sizes.insert(it->first);
+        }
+    }
+    for (auto it = compact_maps.begin(); it != compact_maps.end(); ++it) {
+        if (is_built(it->second)) {
+            sizes.insert(std::make_pair(std::get<0>(it->first), std::get<1>(it->first)));
+        }
+    }
+    return sizes.size();
+}
+
+/**
+ * @brief: Returns dense maps of a capture resolution, builds them when missing,
+ * called with the mutex unlocked
+ * @return: dense maps, empty pointer when the aspect ratio of arg_size differs from the calibration one
+ */
+std::shared_ptr<const RemapMaps> CalibrationModel::find_dense_maps(cv::Size arg_size) const
+{
+    cv::Mat camera_matrix;
+    if (scale_camera_matrix(data, arg_size, camera_matrix) == false) {
+        return std::shared_ptr<const RemapMaps>();
+    }
+    return get_or_build(mutex, dense_maps, std::make_pair(arg_size.width, arg_size.height), [&]() {
+        std::shared_ptr<RemapMaps> maps = std::make_shared<RemapMaps>();
+        build_dense_remap_maps(camera_matrix, data.dist_coeffs, arg_size, *maps);
+        return std::shared_ptr<const RemapMaps>(maps);
+    });
+}
+
+/**
+ * @brief: Check if the model was built from the same calibration data
+ */
+bool CalibrationModel::has_same_data(const CalibrationData &arg_data) const
+{
+    return data.frame_size == arg_data.frame_size and same_matrix(data.cam_matrix, arg_data.cam_matrix)
+            and same_matrix(data.dist_coeffs, arg_data.dist_coeffs);
+}
@@ -0,0 +1,76 @@
+/**
+  @file calibration_model.h
+  @brief A declarations of immutable calibration model shared by cameras, with its remap maps
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef CALIBRATION_MODEL_H
+#define CALIBRATION_MODEL_H
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <opencv2/core.hpp>
+#include "calibration_data.h"
+#include "coarse_remap.h"
+#include "remap_kernels.h"
+
+namespace camera_ns {
+    /**
+     * @brief The CalibrationModel class keeps calibration data which never changes
+     * after construction, and the remap maps built from it for each capture
+     * resolution. Models are obtained with CalibrationModel::get(), which returns
+     * the model already used by another camera when the data is the same, so
+     * cameras with identical lenses build and store the maps once. All methods
+     * are thread safe, maps are built on first use. The mutex guards only the
+     * caches: a map is built outside it, threads asking for the same map wait
+     * for its shared future, and maps of other keys are returned meanwhile.
+     */
+    class CalibrationModel
+    {
+    public:
+        CalibrationModel(const CalibrationModel&) = delete;
+        CalibrationModel& operator=(const CalibrationModel&) = delete;
+
+        static std::shared_ptr<const CalibrationModel> get(const CalibrationData& data);
+        static size_t get_registry_size();
+
+        const CalibrationData& get_data() const;
+        uint64_t get_hash() const;
+        bool get_camera_matrix_for_size(cv::Size arg_size, cv::Mat& camera_matrix) const;
+        bool get_dense_maps(cv::Size arg_size, cv::Mat& map1, cv::Mat& map2) const;
+        std::shared_ptr<const CoarseRemapMap> get_compact_map(cv::Size arg_size, int grid_step,
+                                                              GridInterpolation interpolation) const;
+        std::shared_ptr<const SourceRowIndex> get_source_row_index(cv::Size arg_size, int band_rows) const;
+        size_t get_cached_sizes_count() const;
+
+    private:
+        typedef std::pair<int, int> SizeKey;
+        typedef std::tuple<int, int, int, GridInterpolation> CompactKey;
+        typedef std::tuple<int, int, int> RowIndexKey;
+        typedef std::shared_future<std::shared_ptr<const RemapMaps>> DenseMapsFuture;
+        typedef std::shared_future<std::shared_ptr<const CoarseRemapMap>> CompactMapFuture;
+        typedef std::shared_future<std::shared_ptr<const SourceRowIndex>> RowIndexFuture;
+
+        CalibrationData data;
+        uint64_t hash;
+        mutable std::mutex mutex;
+        mutable std::map<SizeKey, DenseMapsFuture> dense_maps;
+        mutable std::map<CompactKey, CompactMapFuture> compact_maps;
+        mutable std::map<RowIndexKey, RowIndexFuture> row_indexes;
+
+        CalibrationModel(const CalibrationData& arg_data, uint64_t arg_hash);
+        bool has_same_data(const CalibrationData& arg_data) const;
+        std::shared_ptr<const RemapMaps> find_dense_maps(cv::Size arg_size) const;
+    };
+
+    uint64_t hash_calibration_data(const CalibrationData& data);
+}
+
+#endif // CALIBRATION_MODEL_H
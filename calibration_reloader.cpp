@@ -0,0 +1,180 @@
+/**
+  @file calibration_reloader.cpp
+  @brief A definitions of background calibration reloading
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <sys/stat.h>
+#include "calibration_reloader.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: A constructor
+ * @param arg_handler a function called on the reloader thread with new calibration data
+ */
+CalibrationReloader::CalibrationReloader(Handler arg_handler)
+    : handler(arg_handler), running(false), stop_requested(false), has_request(false),
+      poll_interval(0), file_stamp(0), settling_stamp(0)
+{
+}
+
+/**
+ * @brief: A destructor, stops the reloader thread
+ */
+CalibrationReloader::~CalibrationReloader()
+{
+    stop();
+}
+
+/**
+ * @brief: Starts watching a calibration file, the handler is called each time
+ * the file changes and can be read
+ * @param arg_file_name a calibration file name
+ * @param arg_poll_interval an interval of file modification checks
+ * @return: false when arg_poll_interval is not positive
+ */
+bool CalibrationReloader::watch_file(std::string arg_file_name,
+                                     std::chrono::milliseconds arg_poll_interval)
+{
+    if (arg_poll_interval.count() <= 0) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        file_name = arg_file_name;
+        poll_interval = arg_poll_interval;
+        /// the current file content is already loaded, wait for the next change
+        file_changed(file_stamp);
+        settling_stamp = file_stamp;
+    }
+    start();
+    wake_up.notify_one();
+    return true;
+}
+
+/**
+ * @brief: Passes calibration data to the handler on the reloader thread,
+ * a pending request not yet handled is replaced
+ * @param data calibration data
+ */
+void CalibrationReloader::request(const CalibrationData &data)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requested = data;
+        has_request = true;
+    }
+    start();
+    wake_up.notify_one();
+}
+
+/**
+ * @brief: Stops the reloader thread, a pending request is dropped
+ */
+void CalibrationReloader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_requested = true;
+    }
+    wake_up.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+    stop_requested = false;
+    has_request = false;
+    file_name.clear();
+}
+
+/**
+ * @brief: Check if the reloader thread is running
+ * @return: running flag
+ */
+bool CalibrationReloader::get_running() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+/**
+ * @brief: Starts the reloader thread if it is not running
+ */
+void CalibrationReloader::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&CalibrationReloader::run, this);
+}
+
+/**
+ * @brief: The reloader thread loop
+ */
+void CalibrationReloader::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (stop_requested == false) {
+        if (has_request) {
+            CalibrationData data = requested;
+            has_request = false;
+            lock.unlock();
+            handler(data);
+            lock.lock();
+            continue;
+        }
+        if (file_name.empty() == false) {
+            long long stamp = file_stamp;
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (file_changed(stamp) and stamp != settling_stamp) {
+                /// the file may still be written, it is read when the stamp stops changing
+                settling_stamp = stamp;
+                settling_since = now;
+            } else if (stamp != file_stamp and now - settling_since >= poll_interval) {
+                CalibrationData data;
+                std::string name = file_name;
+                lock.unlock();
+                /// a file which does not parse is retried at the next poll
+                bool read = read_calibration_file(name, data);
+                if (read) {
+                    handler(data);
+                }
+                lock.lock();
+                if (read) {
+                    file_stamp = stamp;
+                }
+            }
+            wake_up.wait_for(lock, poll_interval);
+        } else {
+            wake_up.wait(lock);
+        }
+    }
+}
+
+/**
+ * @brief: Checks if the watched file was modified
+ * @param stamp last seen modification stamp, updated when the file changed
+ * @return: true when the file exists and its stamp differs from stamp
+ */
+bool CalibrationReloader::file_changed(long long &stamp) const
+{
+    struct stat file_status;
+    if (file_name.empty() or stat(file_name.c_str(), &file_status) != 0) {
+        return false;
+    }
+    long long current = static_cast<long long>(file_status.st_mtime) * 1000000000LL
+            + static_cast<long long>(file_status.st_mtim.tv_nsec)
+            + static_cast<long long>(file_status.st_size);
+    if (current == stamp) {
+        return false;
+    }
+    stamp = current;
+    return true;
+}
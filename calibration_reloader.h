@@ -0,0 +1,62 @@
+/**
+  @file calibration_reloader.h
+  @brief A declarations of background calibration reloading
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef CALIBRATION_RELOADER_H
+#define CALIBRATION_RELOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "calibration_data.h"
+
+namespace camera_ns {
+    /**
+     * @brief The CalibrationReloader class runs a background thread which watches
+     * a calibration file and takes calibration data passed by the API. New data is
+     * passed to the handler on that thread, so heavy work (e.g. building remap
+     * maps) never runs on the caller or capture thread. A changed file is read only
+     * after its modification stamp has been stable for a poll interval, so a file
+     * caught while being written is not taken.
+     */
+    class CalibrationReloader
+    {
+    public:
+        typedef std::function<void(const CalibrationData&)> Handler;
+
+        explicit CalibrationReloader(Handler arg_handler);
+        ~CalibrationReloader();
+        bool watch_file(std::string arg_file_name, std::chrono::milliseconds arg_poll_interval);
+        void request(const CalibrationData& data);
+        void stop();
+        bool get_running() const;
+
+    private:
+        Handler handler;
+        std::thread worker;
+        mutable std::mutex mutex;
+        std::condition_variable wake_up;
+        bool running;
+        bool stop_requested;
+        bool has_request;
+        CalibrationData requested;
+        std::string file_name;
+        std::chrono::milliseconds poll_interval;
+        long long file_stamp;
+        long long settling_stamp;
+        std::chrono::steady_clock::time_point settling_since;
+
+        void start();
+        void run();
+        bool file_changed(long long& stamp) const;
+    };
+}
+
+#endif // CALIBRATION_RELOADER_H
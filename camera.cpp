@@ -6,6 +6,9 @@
   @version 1.0
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <opencv2/calib3d.hpp>
@@ -13,10 +16,37 @@
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
 #include "camera.h"
+#include "remap_kernels.h"
 
 
 using namespace camera_ns;
 
+/**
+ * @brief: Hashes every row of a frame 8 bytes at a time, a change of any
+ * pixel changes the hash
+ * @param frame a frame
+ * @return: FNV-1a hash of the frame content
+ */
+static uint64_t frame_hash(const cv::Mat& frame)
+{
+    const uint64_t fnv_prime = 1099511628211ULL;
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    uint64_t hash = 14695981039346656037ULL;
+    for (int y = 0; y < frame.rows; ++y) {
+        const uchar* row = frame.ptr<uchar>(y);
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= row_bytes; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, row + i, sizeof(uint64_t));
+            hash = (hash ^ word) * fnv_prime;
+        }
+        for (; i < row_bytes; ++i) {
+            hash = (hash ^ row[i]) * fnv_prime;
+        }
+    }
+    return hash;
+}
+
 /**
  * @brief: A default constructor
  */
@@ -31,15 +61,41 @@ Camera::Camera()
     set_default_camera_calibration_coefs();
     calibration_in_progress = false;
     calibartion_image_number = 0;
-    remap_first_entry = true;
+    set_compact_remap_grid(16, GridInterpolation::bilinear);
+    reset_error_counters();
+    last_correction_type = CorrectionType::remap;
+    set_lazy_compensation(false);
+    set_duplicate_frame_skipping(false);
+    set_duplicate_frame_hashing(false);
+    compensation_requested = false;
+    last_frame_duplicate = false;
+    requested_correction_type = CorrectionType::remap;
+    compensated_correction_type = CorrectionType::remap;
+    capture_sequence = 0;
+    compensated_sequence = 0;
+    duplicate_frames_count = 0;
+    skipped_compensations_count = 0;
+    dropped_compensations_count = 0;
+    reduced_maps_type = CorrectionType::remap;
+    last_frame_hash = 0;
+    last_frame_timestamp = 0.0;
+    set_frame_budget(std::chrono::microseconds(0));
+    distortion_model = DistortionModel::radial3_tangential;
+    shm_slot_count = 0;
+    shm_mode = 0600;
+    shm_export_raw = false;
+    shm_export_compensated = false;
+    active_frame_size = 0;
+    calibration_version = 0;
+    calibration_update_pending = false;
 }
 
 /**
- * @brief: A default destructor
+ * @brief: A default destructor, stops background calibration reloading
  */
 Camera::~Camera()
 {
-
+    stop_calibration_reload();
 }
 
 /**
@@ -139,11 +195,146 @@ bool Camera::set_number_of_images_to_calibrate(uint8_t arg_num)
  */
 bool Camera::set_default_camera_calibration_coefs()
 {
-    cam_matrix = cv::Mat::eye(3,3, CV_64F);
-    dist_coeffs = cv::Mat::zeros(3,3, CV_64F);
+    CalibrationData data;
+    data.cam_matrix = cv::Mat::eye(3,3, CV_64F);
+    data.dist_coeffs = cv::Mat::zeros(3,3, CV_64F);
+    replace_calibration_model(CalibrationModel::get(data));
+    return true;
+}
+
+/**
+ * @brief: Sets the resolution the calibration data was computed at
+ * @param: arg_size The calibration resolution (empty when unknown)
+ * @return: true
+ */
+bool Camera::set_calibration_frame_size(cv::Size arg_size)
+{
+    CalibrationData data = calibration_model->get_data();
+    data.frame_size = arg_size;
+    replace_calibration_model(CalibrationModel::get(data));
+    return true;
+}
+
+/**
+ * @brief: Sets calibration model, e.g. the one of another camera with the same lens,
+ * remap maps already built for the model are reused
+ * @param: arg_model The calibration model
+ * @return: false when arg_model is empty
+ */
+bool Camera::set_calibration_model(std::shared_ptr<const CalibrationModel> arg_model)
+{
+    if (!arg_model) {
+        return false;
+    }
+    replace_calibration_model(arg_model);
+    set_calibrated(true);
+    return true;
+}
+
+/**
+ * @brief: Sets the coarse grid used by CorrectionType::remap_compact
+ * @param: arg_grid_step The distance between grid nodes [px]
+ * @param: arg_interpolation The interpolation between grid nodes
+ * @return: false when arg_grid_step is smaller than 1
+ */
+bool Camera::set_compact_remap_grid(int arg_grid_step, GridInterpolation arg_interpolation)
+{
+    if (arg_grid_step < 1) {
+        return false;
+    }
+    compact_remap_grid_step = arg_grid_step;
+    compact_remap_interpolation = arg_interpolation;
+    compensated_sequence = 0;
     return true;
 }
 
+/**
+ * @brief: Sets lazy compensation: compensate_distortions() only records the request
+ * and the correction runs when the compensated frame is requested by a getter
+ * @param: arg_lazy The lazy compensation flag
+ * @return: true
+ */
+bool Camera::set_lazy_compensation(bool arg_lazy)
+{
+    lazy_compensation = arg_lazy;
+    return true;
+}
+
+/**
+ * @brief: Sets duplicate frame skipping: a frame with the same driver timestamp as
+ * the previous one keeps the capture sequence, so it is not compensated again
+ * @param: arg_skipping The duplicate frame skipping flag
+ * @return: true
+ */
+bool Camera::set_duplicate_frame_skipping(bool arg_skipping)
+{
+    duplicate_frame_skipping = arg_skipping;
+    return true;
+}
+
+/**
+ * @brief: Sets duplicate frame hashing: with duplicate frame skipping set, a frame
+ * with the same content as the previous one is a duplicate as well, for devices
+ * without timestamps. Every captured frame is hashed whole.
+ * @param: arg_hashing The duplicate frame hashing flag
+ * @return: true
+ */
+bool Camera::set_duplicate_frame_hashing(bool arg_hashing)
+{
+    duplicate_frame_hashing = arg_hashing;
+    last_frame_hash = 0;
+    return true;
+}
+
+/**
+ * @brief: Sets the per-frame correction budget (deadline mode). When the measured
+ * correction cost exceeds it, the quality steps down: nearest interpolation, then
+ * half resolution output, then correction of every second frame only. It steps
+ * back up when there is enough headroom.
+ * @param: arg_budget The correction budget, 0 disables deadline mode
+ * @return: false when arg_budget is negative
+ */
+bool Camera::set_frame_budget(std::chrono::microseconds arg_budget)
+{
+    if (arg_budget.count() < 0) {
+        return false;
+    }
+    frame_budget = arg_budget;
+    correction_quality = CorrectionQuality::full;
+    correction_cost_us = 0.0;
+    quality_settle_frames = 0;
+    quality_headroom_frames = 0;
+    alternate_frame_skip = false;
+    return true;
+}
+
+/**
+ * @brief: Sets the distortion model estimated by calibrate()
+ * @param: arg_model The distortion model
+ * @return: true
+ */
+bool Camera::set_distortion_model(DistortionModel arg_model)
+{
+    distortion_model = arg_model;
+    return true;
+}
+
+/**
+ * @brief: Switches the camera capture mode, calibration data is scaled
+ * to the new resolution on the next compensation
+ * @param: arg_size The requested capture resolution
+ * @return: true when the camera accepted the new resolution
+ */
+bool Camera::set_capture_resolution(cv::Size arg_size)
+{
+    if (cam.isOpened() == false) {
+        open();
+    }
+    bool res = cam.set(CV_CAP_PROP_FRAME_WIDTH, arg_size.width);
+    res = cam.set(CV_CAP_PROP_FRAME_HEIGHT, arg_size.height) and res;
+    return res;
+}
+
 /**
  * @brief: Returns a width (card placed horizontally) of chessboard
  * @return: A width of chessboard (card placed horizontally)
@@ -194,8 +385,9 @@ cv::Mat Camera::get_frame_raw() const
  * @brief: Returns a calibrated frame
  * @return: a cv::Mat frame
  */
-cv::Mat Camera::get_frame_calibrated() const
+cv::Mat Camera::get_frame_calibrated()
 {
+    resolve_lazy_compensation();
     return frame_compensated;
 }
 
@@ -205,7 +397,7 @@ cv::Mat Camera::get_frame_calibrated() const
  */
 cv::Mat Camera::get_camera_matrix() const
 {
-    return cam_matrix;
+    return calibration_model->get_data().cam_matrix.clone();
 }
 
 /**
@@ -214,7 +406,268 @@ cv::Mat Camera::get_camera_matrix() const
  */
 cv::Mat Camera::get_dist_coefs() const
 {
-    return dist_coeffs;
+    return calibration_model->get_data().dist_coeffs.clone();
+}
+
+/**
+ * @brief: Returns camera matrix scaled to a capture resolution
+ * @param arg_size The capture resolution
+ * @return: camera matrix valid for arg_size
+ */
+cv::Mat Camera::get_camera_matrix_for_size(cv::Size arg_size) const
+{
+    cv::Mat camera_matrix;
+    if (calibration_model->get_camera_matrix_for_size(arg_size, camera_matrix) == false) {
+        throw make_resolution_mismatch(arg_size);
+    }
+    return camera_matrix;
+}
+
+/**
+ * @brief: Makes the exception thrown when calibration data cannot be scaled to a resolution
+ * @param arg_size The capture resolution
+ * @return: exception message
+ */
+ExceptionMessage Camera::make_resolution_mismatch(cv::Size arg_size) const
+{
+    const cv::Size calibration_size = get_calibration_frame_size();
+    ExceptionMessage em;
+    em.msg = "Cannot scale calibration data from " + std::to_string(calibration_size.width)
+            + "x" + std::to_string(calibration_size.height) + " to "
+            + std::to_string(arg_size.width) + "x" + std::to_string(arg_size.height);
+    em.id = ExceptionID::calibration_resolution_mismatch;
+    return em;
+}
+
+/**
+ * @brief: Returns the resolution the calibration data was computed at
+ * @return: calibration resolution (empty when unknown)
+ */
+cv::Size Camera::get_calibration_frame_size() const
+{
+    return calibration_model->get_data().frame_size;
+}
+
+/**
+ * @brief: Returns the calibration data currently in use
+ * @return: camera matrix, dist coefficients and calibration resolution
+ */
+CalibrationData Camera::get_calibration_data() const
+{
+    const CalibrationData& model_data = calibration_model->get_data();
+    CalibrationData data;
+    data.cam_matrix = model_data.cam_matrix.clone();
+    data.dist_coeffs = model_data.dist_coeffs.clone();
+    data.frame_size = model_data.frame_size;
+    return data;
+}
+
+/**
+ * @brief: Returns the calibration model currently in use, it can be
+ * passed to other cameras with the same lens
+ * @return: calibration model
+ */
+std::shared_ptr<const CalibrationModel> Camera::get_calibration_model() const
+{
+    return calibration_model;
+}
+
+/**
+ * @brief: Returns the number of calibration updates applied by reloading
+ * @return: calibration version
+ */
+uint64_t Camera::get_calibration_version() const
+{
+    return calibration_version;
+}
+
+/**
+ * @brief: Check if reloaded calibration waits for the next frame boundary
+ * @return: pending flag
+ */
+bool Camera::get_calibration_update_pending() const
+{
+    return calibration_update_pending;
+}
+
+/**
+ * @brief: Check if lazy compensation is set
+ * @return: lazy compensation flag
+ */
+bool Camera::get_lazy_compensation() const
+{
+    return lazy_compensation;
+}
+
+/**
+ * @brief: Check if duplicate frame skipping is set
+ * @return: duplicate frame skipping flag
+ */
+bool Camera::get_duplicate_frame_skipping() const
+{
+    return duplicate_frame_skipping;
+}
+
+/**
+ * @brief: Check if duplicate frame hashing is set
+ * @return: duplicate frame hashing flag
+ */
+bool Camera::get_duplicate_frame_hashing() const
+{
+    return duplicate_frame_hashing;
+}
+
+/**
+ * @brief: Check if the last read frame repeated the previous one
+ * @return: duplicate flag
+ */
+bool Camera::get_last_frame_duplicate() const
+{
+    return last_frame_duplicate;
+}
+
+/**
+ * @brief: Returns the sequence number of the captured frame, duplicates keep the number
+ * @return: capture sequence (0 before the first frame)
+ */
+uint64_t Camera::get_capture_sequence() const
+{
+    return capture_sequence;
+}
+
+/**
+ * @brief: Returns number of read frames recognized as duplicates
+ * @return: duplicate frames count
+ */
+uint64_t Camera::get_duplicate_frames_count() const
+{
+    return duplicate_frames_count;
+}
+
+/**
+ * @brief: Returns number of compensations skipped because the result for
+ * the captured frame was already computed
+ * @return: skipped compensations count
+ */
+uint64_t Camera::get_skipped_compensations_count() const
+{
+    return skipped_compensations_count;
+}
+
+/**
+ * @brief: Returns number of compensations dropped in deadline mode
+ * (CorrectionQuality::alternate_frames), the previous compensated frame was kept
+ * @return: dropped compensations count
+ */
+uint64_t Camera::get_dropped_compensations_count() const
+{
+    return dropped_compensations_count;
+}
+
+/**
+ * @brief: Returns the per-frame correction budget
+ * @return: correction budget (0 when deadline mode is off)
+ */
+std::chrono::microseconds Camera::get_frame_budget() const
+{
+    return frame_budget;
+}
+
+/**
+ * @brief: Returns the correction quality level chosen in deadline mode
+ * @return: correction quality
+ */
+CorrectionQuality Camera::get_correction_quality() const
+{
+    return correction_quality;
+}
+
+/**
+ * @brief: Returns the averaged cost of single correction measured in deadline mode
+ * @return: correction cost [us]
+ */
+double Camera::get_correction_cost() const
+{
+    return correction_cost_us;
+}
+
+/**
+ * @brief: Returns the distortion model estimated by calibrate()
+ * @return: distortion model
+ */
+DistortionModel Camera::get_distortion_model() const
+{
+    return distortion_model;
+}
+
+/**
+ * @brief: Returns number of capture resolutions with remap maps built in
+ * the calibration model (shared with other cameras using the model)
+ * @return: remap cache size
+ */
+size_t Camera::get_remap_cache_size() const
+{
+    return calibration_model->get_cached_sizes_count();
+}
+
+/**
+ * @brief: Returns the distance between compact remap grid nodes
+ * @return: grid step [px]
+ */
+int Camera::get_compact_remap_grid_step() const
+{
+    return compact_remap_grid_step;
+}
+
+/**
+ * @brief: Returns the interpolation used between compact remap grid nodes
+ * @return: grid interpolation
+ */
+GridInterpolation Camera::get_compact_remap_interpolation() const
+{
+    return compact_remap_interpolation;
+}
+
+/**
+ * @brief: Measures the maximal error of the compact remap map against the dense one,
+ * the dense map is built only for the measurement and is not cached
+ * @param arg_size The capture resolution
+ * @return: maximal source coordinates error [px]
+ */
+float Camera::get_compact_remap_max_error(cv::Size arg_size)
+{
+    if (select_compact_remap_map(arg_size) == false) {
+        throw make_resolution_mismatch(arg_size);
+    }
+    const CoarseRemapMap& compact = *compact_remap_map;
+    cv::Mat camera_matrix = get_camera_matrix_for_size(arg_size);
+    const cv::Mat& dist_coeffs = calibration_model->get_data().dist_coeffs;
+    cv::Mat map_x, map_y;
+    build_undistort_maps(camera_matrix, dist_coeffs,
+                         get_new_camera_matrix(camera_matrix, dist_coeffs, arg_size),
+                         arg_size, CV_32FC1, map_x, map_y);
+    return compact.max_error(map_x, map_y);
+}
+
+/**
+ * @brief: Returns how many times the non-throwing calls returned a status
+ * @param arg_id The status
+ * @return: number of occurrences since the last reset
+ */
+uint64_t Camera::get_error_count(ExceptionID arg_id) const
+{
+    if (arg_id == ExceptionID::ok) {
+        return 0;
+    }
+    return error_counters[static_cast<size_t>(arg_id)];
+}
+
+/**
+ * @brief: Sets all error counters to 0
+ */
+void Camera::reset_error_counters()
+{
+    error_counters.fill(0);
 }
 
 /**
@@ -232,6 +685,7 @@ cv::Mat *Camera::get_pointer_to_frame_raw()
  */
 cv::Mat *Camera::get_pointer_to_frame_calibrated()
 {
+    resolve_lazy_compensation();
     return &frame_compensated;
 }
 
@@ -250,6 +704,7 @@ cv::Mat &Camera::get_reference_to_frame_raw()
  */
 cv::Mat &Camera::get_reference_to_frame_calibrated()
 {
+    resolve_lazy_compensation();
     return frame_compensated;
 }
 
@@ -412,15 +867,83 @@ bool Camera::read()
         open();
     }
     bool res = cam.read(captured_frame);
-    frame_size = captured_frame.size();
+    set_frame_size(captured_frame.size());
+    if (res and captured_frame.empty() == false) {
+        register_captured_frame(true);
+    }
     return res;
 }
 
+/**
+ * @brief: Read data from camera without throwing, for per-frame use
+ * @return: ExceptionID::ok or the failure reason
+ */
+ExceptionID Camera::try_read() noexcept
+{
+    ExceptionID status = ExceptionID::ok;
+    try {
+        if (camera_id == -1) {
+            status = ExceptionID::camera_wrong_id;
+        } else if (cam.isOpened() == false and cam.open(camera_id) == false) {
+            status = ExceptionID::camera_open_failure;
+        } else if (cam.read(captured_frame) == false) {
+            status = ExceptionID::camera_reading_failure;
+        } else if (captured_frame.empty() == true) {
+            status = ExceptionID::empty_frame;
+        } else {
+            set_frame_size(captured_frame.size());
+            register_captured_frame(true);
+        }
+    } catch (...) {
+        status = ExceptionID::camera_reading_failure;
+    }
+    return count_status(status);
+}
+
+/**
+ * @brief: Compensate distortions without throwing, for per-frame use
+ * @param ct The correction algorithm
+ * @return: ExceptionID::ok or the failure reason
+ */
+ExceptionID Camera::try_compensate_distortions(CorrectionType ct) noexcept
+{
+    ExceptionID status = ExceptionID::ok;
+    apply_pending_calibration();
+    if (calibrated == false) {
+        status = ExceptionID::no_calibration_data;
+    } else if (captured_frame.empty() == true) {
+        status = ExceptionID::empty_frame;
+    } else {
+        try {
+            status = request_compensation(ct);
+        } catch (const ExceptionMessage& em) {
+            status = em.id;
+        } catch (...) {
+            status = ExceptionID::correction_failure;
+        }
+    }
+    return count_status(status);
+}
+
+/**
+ * @brief: Increments the counter of a non-ok status
+ * @param status The status
+ * @return: status
+ */
+ExceptionID Camera::count_status(ExceptionID status) noexcept
+{
+    if (status != ExceptionID::ok) {
+        ++error_counters[static_cast<size_t>(status)];
+    }
+    return status;
+}
+
 /**
  * @brief: Compensate distortions using selected algorithm
  */
 void Camera::compensate_distortions(CorrectionType ct)
 {
+    apply_pending_calibration();
     if (calibrated == false) {
         ExceptionMessage em;
         em.msg = "Cannot compensate image without calibration data";
@@ -433,27 +956,478 @@ void Camera::compensate_distortions(CorrectionType ct)
         em.id = ExceptionID::empty_frame;
         throw em;
     }
+    if (request_compensation(ct) == ExceptionID::calibration_resolution_mismatch) {
+        throw make_resolution_mismatch(captured_frame.size());
+    }
+}
+
+/**
+ * @brief: Reads a frame from an incremental source and compensates it with
+ * CorrectionType::remap band by band: each band is remapped as soon as the source
+ * rows it samples (see SourceRowIndex) have arrived, so the correction overlaps
+ * the frame readout. Lazy compensation and the frame budget do not apply.
+ * The frame is read and compensated into separate buffers, which replace the
+ * captured and compensated frames only when the whole frame has arrived: when the
+ * source fails mid-frame the previous frames and their sequence number are kept.
+ * @param source The frame source
+ * @param handler Called with each compensated band, in order from the top
+ * @param band_rows The number of rows in a band
+ * @return: false when the source has no more frames
+ */
+bool Camera::compensate_streaming(IncrementalFrameSource &source, const BandHandler &handler, int band_rows)
+{
+    apply_pending_calibration();
+    if (calibrated == false) {
+        ExceptionMessage em;
+        em.msg = "Cannot compensate image without calibration data";
+        em.id = ExceptionID::no_calibration_data;
+        throw em;
+    }
+    /// the buffers are reused between frames, but never while shared with the frames they replace
+    if (streamed_frame.data == captured_frame.data or streamed_frame.data == frame_compensated.data) {
+        streamed_frame = cv::Mat();
+    }
+    if (source.begin_frame(streamed_frame) == false) {
+        return false;
+    }
+    if (streamed_compensated.data == streamed_frame.data or streamed_compensated.data == captured_frame.data
+            or streamed_compensated.data == frame_compensated.data) {
+        streamed_compensated = cv::Mat();
+    }
+    set_frame_size(streamed_frame.size());
+    last_correction_type = CorrectionType::remap;
+    if (select_remap_maps(frame_size) == false) {
+        throw make_resolution_mismatch(frame_size);
+    }
+    std::shared_ptr<const SourceRowIndex> row_index =
+            calibration_model->get_source_row_index(frame_size, std::max(band_rows, 1));
+    streamed_compensated.create(frame_size, streamed_frame.type());
+
+    int rows_ready = 0;
+    for (size_t band = 0; band < row_index->source_rows.size(); ++band) {
+        const int first_row = static_cast<int>(band) * row_index->band_rows;
+        const cv::Range rows(first_row, std::min(first_row + row_index->band_rows, frame_size.height));
+        rows_ready = wait_for_rows(source, streamed_frame, rows_ready, row_index->source_rows[band].end);
+        remap_band(streamed_frame, streamed_compensated, remap_map1, remap_map2, RemapInterpolation::linear, rows);
+        if (handler) {
+            handler(streamed_compensated.rowRange(rows), rows.start);
+        }
+    }
+    /// rows below the last sampled one are still part of the raw frame
+    wait_for_rows(source, streamed_frame, rows_ready, frame_size.height);
+    std::swap(captured_frame, streamed_frame);
+    std::swap(frame_compensated, streamed_compensated);
+    register_captured_frame(false);
+    compensated_sequence = capture_sequence;
+    compensated_correction_type = CorrectionType::remap;
+    if (shm_export_compensated) {
+        export_frame(compensated_publisher, "_compensated", frame_compensated, shm_export_compensated);
+    }
+    return true;
+}
+
+/**
+ * @brief: Reads rows of a frame from an incremental source
+ * @param source The frame source
+ * @param frame The frame passed to IncrementalFrameSource::begin_frame()
+ * @param rows_ready The number of rows already read
+ * @param rows_needed The number of rows to wait for
+ * @return: number of rows read, at least rows_needed
+ */
+int Camera::wait_for_rows(IncrementalFrameSource &source, cv::Mat &frame, int rows_ready, int rows_needed)
+{
+    while (rows_ready < rows_needed) {
+        int rows = source.read_rows(frame);
+        if (rows <= rows_ready) {
+            ExceptionMessage em;
+            em.msg = "Frame source ended before the frame was complete";
+            em.id = ExceptionID::camera_reading_failure;
+            throw em;
+        }
+        rows_ready = rows;
+    }
+    return rows_ready;
+}
 
+/**
+ * @brief: Compensates the captured frame now or, in lazy mode, when
+ * the compensated frame is requested
+ * @param ct The correction algorithm
+ * @return: ExceptionID::ok or calibration_resolution_mismatch
+ */
+ExceptionID Camera::request_compensation(CorrectionType ct)
+{
+    if (lazy_compensation) {
+        requested_correction_type = ct;
+        compensation_requested = true;
+        return ExceptionID::ok;
+    }
+    return compensate_current_frame(ct);
+}
+
+/**
+ * @brief: Compensates the captured frame unless it was already compensated
+ * with the same algorithm. The sequence number is trusted only in lazy or duplicate
+ * skipping mode; otherwise the raw frame may have been changed through the
+ * raw frame pointer or reference, so it is always compensated again.
+ * @param ct The correction algorithm
+ * @return: ExceptionID::ok or calibration_resolution_mismatch
+ */
+ExceptionID Camera::compensate_current_frame(CorrectionType ct)
+{
+    if ((lazy_compensation or duplicate_frame_skipping) and capture_sequence != 0
+            and compensated_sequence == capture_sequence and compensated_correction_type == ct) {
+        ++skipped_compensations_count;
+        return ExceptionID::ok;
+    }
+    ExceptionID status = ExceptionID::ok;
+    if (frame_budget.count() == 0) {
+        status = compensate_frame(ct);
+    } else {
+        if (correction_quality == CorrectionQuality::alternate_frames) {
+            alternate_frame_skip = !alternate_frame_skip;
+            if (alternate_frame_skip) {
+                /// the previous compensated frame is kept
+                ++dropped_compensations_count;
+                return ExceptionID::ok;
+            }
+        }
+        const uchar* dense_maps = remap_map1.data;
+        const CoarseRemapMap* compact_map = compact_remap_map.get();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        status = compensate_frame(ct);
+        std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+        /// a frame which selected other maps may include their build, it is not measured
+        const bool maps_selected = remap_map1.data != dense_maps or compact_remap_map.get() != compact_map;
+        if (status == ExceptionID::ok and maps_selected == false) {
+            update_correction_quality(std::chrono::duration<double, std::micro>(stop - start).count());
+        }
+    }
+    if (status != ExceptionID::ok) {
+        return status;
+    }
+    compensated_sequence = capture_sequence;
+    compensated_correction_type = ct;
+    if (shm_export_compensated) {
+        export_frame(compensated_publisher, "_compensated", frame_compensated, shm_export_compensated);
+    }
+    return ExceptionID::ok;
+}
+
+/**
+ * @brief: Steps the correction quality down when the averaged cost exceeds
+ * the budget and up when it stays well below the budget
+ * @param cost_us The cost of the last correction [us]
+ */
+void Camera::update_correction_quality(double cost_us)
+{
+    /// number of frames measured before the next decision after a level change
+    const int settle_frames = 5;
+    /// number of frames with headroom needed to step up
+    const int headroom_frames = 30;
+    const double headroom_ratio = 0.5;
+
+    correction_cost_us = quality_settle_frames == 0 ? cost_us
+                                                    : 0.8 * correction_cost_us + 0.2 * cost_us;
+    if (++quality_settle_frames < settle_frames) {
+        return;
+    }
+    const double budget_us = static_cast<double>(frame_budget.count());
+    int level = static_cast<int>(correction_quality);
+    if (correction_cost_us > budget_us) {
+        quality_headroom_frames = 0;
+        if (correction_quality != CorrectionQuality::alternate_frames) {
+            correction_quality = static_cast<CorrectionQuality>(level + 1);
+            quality_settle_frames = 0;
+            if (correction_quality == CorrectionQuality::nearest) {
+                /// the next level needs half resolution maps, they are built before it is reached
+                prebuild_reduced_maps(last_correction_type);
+            }
+        }
+    } else if (correction_cost_us < headroom_ratio * budget_us
+               and correction_quality != CorrectionQuality::full) {
+        if (++quality_headroom_frames >= headroom_frames) {
+            correction_quality = static_cast<CorrectionQuality>(level - 1);
+            quality_settle_frames = 0;
+            quality_headroom_frames = 0;
+        }
+    } else {
+        quality_headroom_frames = 0;
+    }
+}
+
+/**
+ * @brief: Starts building remap maps of half the capture resolution on a background
+ * thread, so stepping down to CorrectionQuality::reduced_resolution does not build
+ * them inside a frame which is already over budget
+ * @param ct The correction algorithm
+ */
+void Camera::prebuild_reduced_maps(CorrectionType ct)
+{
+    const cv::Size reduced_size(frame_size.width / 2, frame_size.height / 2);
+    if (get_calibration_frame_size().area() <= 0 or reduced_size.area() <= 0) {
+        return;
+    }
+    /// the future of a running build would block on reassignment, it is started again when done
+    if (reduced_maps_build.valid()
+            and reduced_maps_build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    std::shared_ptr<const CalibrationModel> model = calibration_model;
+    const int grid_step = compact_remap_grid_step;
+    const GridInterpolation grid_interpolation = compact_remap_interpolation;
+    reduced_maps_model = model;
+    reduced_maps_size = reduced_size;
+    reduced_maps_type = ct;
+    reduced_maps_build = std::async(std::launch::async,
+                                    [model, reduced_size, ct, grid_step, grid_interpolation]() {
+        /// the maps are kept by the model, undistort uses dense maps below full quality
+        if (ct == CorrectionType::remap_compact) {
+            model->get_compact_map(reduced_size, grid_step, grid_interpolation);
+        } else {
+            cv::Mat map1, map2;
+            model->get_dense_maps(reduced_size, map1, map2);
+        }
+    });
+}
+
+/**
+ * @brief: Check if half resolution maps for the captured frame are built,
+ * starts building them when they are missing
+ * @param ct The correction algorithm
+ * @return: true when half resolution correction does not need to build maps
+ */
+bool Camera::get_reduced_maps_ready(CorrectionType ct)
+{
+    const cv::Size reduced_size(frame_size.width / 2, frame_size.height / 2);
+    const bool same_type = (reduced_maps_type == CorrectionType::remap_compact)
+            == (ct == CorrectionType::remap_compact);
+    if (reduced_maps_build.valid() == false or reduced_maps_model.lock() != calibration_model
+            or reduced_maps_size != reduced_size or same_type == false) {
+        prebuild_reduced_maps(ct);
+        return false;
+    }
+    return reduced_maps_build.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/**
+ * @brief: Runs the compensation recorded in lazy mode, failures are
+ * counted like in try_compensate_distortions()
+ */
+void Camera::resolve_lazy_compensation()
+{
+    if (compensation_requested == false) {
+        return;
+    }
+    compensation_requested = false;
+    try {
+        count_status(compensate_current_frame(requested_correction_type));
+    } catch (const ExceptionMessage& em) {
+        count_status(em.id);
+    } catch (...) {
+        count_status(ExceptionID::correction_failure);
+    }
+}
+
+/**
+ * @brief: Assigns a sequence number to the captured frame, a duplicate of
+ * the previous frame keeps its number when duplicate frame skipping is set
+ * @param arg_device_timestamp The frame was read from the capture device, so its
+ * timestamp is compared too; frames of other sources are compared by content only
+ */
+void Camera::register_captured_frame(bool arg_device_timestamp)
+{
+    last_frame_duplicate = false;
+    if (duplicate_frame_skipping) {
+        double timestamp = arg_device_timestamp ? cam.get(CV_CAP_PROP_POS_MSEC) : 0.0;
+        uint64_t hash = duplicate_frame_hashing ? frame_hash(captured_frame) : 0;
+        bool same_timestamp = timestamp > 0.0 and timestamp == last_frame_timestamp;
+        bool same_content = duplicate_frame_hashing and hash == last_frame_hash;
+        last_frame_duplicate = capture_sequence != 0 and (same_timestamp or same_content);
+        last_frame_timestamp = timestamp;
+        last_frame_hash = hash;
+        if (last_frame_duplicate) {
+            ++duplicate_frames_count;
+            return;
+        }
+    }
+    ++capture_sequence;
+    if (shm_export_raw) {
+        export_frame(raw_publisher, "_raw", captured_frame, shm_export_raw);
+    }
+}
+
+/**
+ * @brief: Publishes a frame to a shared memory ring. The ring is created when the
+ * frame does not fit its slots; this camera's own ring is closed first, a segment
+ * of another publisher is never replaced. When the ring cannot be created the
+ * stream is disabled and shared_memory_export_failure is counted, so later
+ * frames do not retry it.
+ * @param publisher the ring publisher
+ * @param suffix the segment name suffix
+ * @param frame the frame to publish
+ * @param export_enabled the export flag of the stream, cleared on failure
+ */
+void Camera::export_frame(ShmFramePublisher &publisher, const std::string &suffix, const cv::Mat &frame,
+                          bool &export_enabled)
+{
+    size_t frame_bytes = frame.total() * frame.elemSize();
+    if (frame_bytes == 0) {
+        return;
+    }
+    if (publisher.get_slot_bytes() < frame_bytes
+            and publisher.create(shm_export_name + suffix, shm_slot_count, frame_bytes, shm_mode) == false) {
+        export_enabled = false;
+        count_status(ExceptionID::shared_memory_export_failure);
+        return;
+    }
+    publisher.publish(frame, capture_sequence);
+}
+
+/**
+ * @brief: Compensation backend shared by the throwing and non-throwing calls
+ * @param ct The correction algorithm
+ * @return: ExceptionID::ok or calibration_resolution_mismatch
+ */
+ExceptionID Camera::compensate_frame(CorrectionType ct)
+{
+    last_correction_type = ct;
+    /// the frame may have been replaced through get_reference_to_frame_raw()
+    if (captured_frame.size() != frame_size) {
+        set_frame_size(captured_frame.size());
+    }
+    RemapInterpolation interpolation = RemapInterpolation::linear;
+    if (correction_quality != CorrectionQuality::full) {
+        interpolation = RemapInterpolation::nearest;
+    }
+    /// calibration data can be scaled to half resolution only when its resolution is known,
+    /// until the maps are built in the background the frame is corrected at full resolution
+    if (correction_quality >= CorrectionQuality::reduced_resolution
+            and get_calibration_frame_size().area() > 0 and get_reduced_maps_ready(ct)) {
+        cv::resize(captured_frame, frame_reduced,
+                   cv::Size(captured_frame.cols / 2, captured_frame.rows / 2), 0, 0, cv::INTER_NEAREST);
+        return correct(ct, frame_reduced, interpolation);
+    }
+    return correct(ct, captured_frame, interpolation);
+}
+
+/**
+ * @brief: Runs the correction algorithm on a frame
+ * @param ct The correction algorithm
+ * @param source The frame to correct (captured or reduced frame)
+ * @param interpolation The sampling method of remap algorithms
+ * @return: ExceptionID::ok or calibration_resolution_mismatch, checked on every
+ * frame, so no exception message is built here
+ */
+ExceptionID Camera::correct(CorrectionType ct, const cv::Mat &source, RemapInterpolation interpolation)
+{
+    const cv::Size size = source.size();
+    const int cv_interpolation = interpolation == RemapInterpolation::nearest ? cv::INTER_NEAREST
+                                                                              : cv::INTER_LINEAR;
+    /// cv::undistort has no interpolation argument, below full quality the dense maps
+    /// (built with the same new camera matrix) are used instead
+    if (ct == CorrectionType::undistort and interpolation == RemapInterpolation::nearest) {
+        ct = CorrectionType::remap;
+    }
     switch(ct){
         case CorrectionType::remap:
-            if (remap_first_entry) {
-                remap_first_entry = false;
-                initUndistortRectifyMap(cam_matrix, dist_coeffs, cv::Mat(),
-                                        getOptimalNewCameraMatrix(cam_matrix, dist_coeffs,
-                                                                  frame_size, 1, frame_size, 0),
-                                        frame_size, CV_16SC2, remap_map1, remap_map2);
+            if (remap_map1.size() != size and select_remap_maps(size) == false) {
+                return ExceptionID::calibration_resolution_mismatch;
+            }
+            if (remap_frame(source, frame_compensated, remap_map1, remap_map2,
+                            interpolation) == false) {
+                remap(source, frame_compensated, remap_map1, remap_map2, cv_interpolation);
             }
-            remap(captured_frame, frame_compensated, remap_map1, remap_map2, cv::INTER_LINEAR);
             break;
-        case CorrectionType::undistort:
-            undistort(captured_frame, frame_compensated,
-                      getOptimalNewCameraMatrix(cam_matrix, dist_coeffs,
-                      frame_size, 1, frame_size, nullptr), dist_coeffs);
+        case CorrectionType::remap_compact: {
+            if (select_compact_remap_map(size) == false) {
+                return ExceptionID::calibration_resolution_mismatch;
+            }
+            const CoarseRemapMap& compact = *compact_remap_map;
+            if (remap_frame(source, frame_compensated, compact, interpolation) == false) {
+                cv::Mat map_x, map_y;
+                compact.expand(map_x, map_y);
+                remap(source, frame_compensated, map_x, map_y, cv_interpolation);
+            }
+            break;
+        }
+        case CorrectionType::undistort: {
+            cv::Mat camera_matrix;
+            if (calibration_model->get_camera_matrix_for_size(size, camera_matrix) == false) {
+                return ExceptionID::calibration_resolution_mismatch;
+            }
+            const cv::Mat& dist_coeffs = calibration_model->get_data().dist_coeffs;
+            undistort(source, frame_compensated, camera_matrix, dist_coeffs,
+                      get_new_camera_matrix(camera_matrix, dist_coeffs, size));
             break;
+        }
         default:
-            frame_compensated = captured_frame;
+            frame_compensated = source;
             break;
     }
+    return ExceptionID::ok;
+}
+
+/**
+ * @brief: Makes remap maps for a capture resolution active, the calibration
+ * model builds them when the resolution is seen for the first time
+ * @param arg_size The capture resolution
+ * @return: false when calibration data cannot be scaled to arg_size
+ */
+bool Camera::select_remap_maps(cv::Size arg_size)
+{
+    return calibration_model->get_dense_maps(arg_size, remap_map1, remap_map2);
+}
+
+/**
+ * @brief: Makes the compact remap map for a capture resolution active,
+ * builds it when it is missing or the grid settings have changed
+ * @param arg_size The capture resolution
+ * @return: false when calibration data cannot be scaled to arg_size
+ */
+bool Camera::select_compact_remap_map(cv::Size arg_size)
+{
+    if (!compact_remap_map or compact_remap_map->size() != arg_size
+            or compact_remap_map->get_grid_step() != compact_remap_grid_step
+            or compact_remap_map->get_interpolation() != compact_remap_interpolation) {
+        compact_remap_map = calibration_model->get_compact_map(arg_size, compact_remap_grid_step,
+                                                               compact_remap_interpolation);
+    }
+    return static_cast<bool>(compact_remap_map);
+}
+
+/**
+ * @brief: Makes a calibration model active, maps selected from the previous one are dropped
+ * @param arg_model The calibration model
+ */
+void Camera::replace_calibration_model(std::shared_ptr<const CalibrationModel> arg_model)
+{
+    calibration_model = arg_model;
+    clear_remap_cache();
+}
+
+/**
+ * @brief: Sets the size of the last captured frame
+ * @param arg_size The frame size
+ */
+void Camera::set_frame_size(cv::Size arg_size)
+{
+    frame_size = arg_size;
+    /// published for the background map builder
+    active_frame_size.store((static_cast<uint64_t>(arg_size.width) << 32)
+                            | static_cast<uint32_t>(arg_size.height), std::memory_order_relaxed);
+}
+
+/**
+ * @brief: Drops remap maps selected by the camera, they are selected again on demand;
+ * maps kept by the calibration model are released with the last camera using it
+ */
+void Camera::clear_remap_cache()
+{
+    compensated_sequence = 0;
+    remap_map1 = cv::Mat();
+    remap_map2 = cv::Mat();
+    compact_remap_map.reset();
 }
 
 /**
@@ -472,9 +1446,40 @@ void Camera::calibration_backend(std::vector<cv::Mat> calibration_images)
     }
     get_chessboard_corners(calibration_images,
                            chessboard_image_space_points, false);
+    calibrate_from_image_points(chessboard_image_space_points, calibration_images[0].size());
+}
 
-    std::vector<std::vector<cv::Point3f>> world_space_corner_points(1);
+/**
+ * @brief: Calibrates the camera from chessboard corners found in images,
+ * estimates coefficients of the model set with set_distortion_model()
+ * @param arg_image_points Chessboard corners of every view, in the order of get_known_board_positions()
+ * @param arg_image_size A size of calibration images
+ * @return: RMS reprojection error [px]
+ */
+double Camera::calibrate_from_image_points(const std::vector<std::vector<cv::Point2f>> &arg_image_points,
+                                           cv::Size arg_image_size)
+{
+    return calibrate_from_image_points(arg_image_points, arg_image_size,
+                                       get_distortion_model_flags(distortion_model));
+}
 
+/**
+ * @brief: Calibrates the camera from chessboard corners found in images
+ * @param arg_image_points Chessboard corners of every view, in the order of get_known_board_positions()
+ * @param arg_image_size A size of calibration images
+ * @param arg_flags openCV calibrateCamera flags (e.g. distortion model)
+ * @return: RMS reprojection error [px]
+ */
+double Camera::calibrate_from_image_points(const std::vector<std::vector<cv::Point2f>> &arg_image_points,
+                                           cv::Size arg_image_size, int arg_flags)
+{
+    if (arg_image_points.size() == 0) {
+        ExceptionMessage em;
+        em.msg = "Cannot calibrate camera with no chessboard views";
+        em.id = ExceptionID::no_calibration_images;
+        calibration_in_progress = false;
+        throw em;
+    }
     if (chessboard_dimensions.width == 0 or chessboard_dimensions.height == 0) {
         ExceptionMessage em;
         em.msg = "Cannot calibrate camera with chessboard 0 dimension";
@@ -482,15 +1487,54 @@ void Camera::calibration_backend(std::vector<cv::Mat> calibration_images)
         calibration_in_progress = false;
         throw em;
     }
+    std::vector<std::vector<cv::Point3f>> world_space_corner_points(1);
     create_known_board_positions(world_space_corner_points[0]);
-    world_space_corner_points.resize(chessboard_image_space_points.size(),
+    world_space_corner_points.resize(arg_image_points.size(),
                                      world_space_corner_points[0]);
 
     std::vector<cv::Mat> r_vectors, t_vectors;
-    dist_coeffs = cv::Mat::zeros(8, 1, CV_64F);
+    CalibrationData data;
+    data.cam_matrix = cv::Mat::eye(3, 3, CV_64F);
+    data.dist_coeffs = cv::Mat::zeros((arg_flags & cv::CALIB_THIN_PRISM_MODEL) != 0 ? 12 : 8, 1, CV_64F);
+    data.frame_size = arg_image_size;
 
-    calibrateCamera(world_space_corner_points, chessboard_image_space_points,
-                    chessboard_dimensions, cam_matrix, dist_coeffs, r_vectors, t_vectors);
+    double rms = calibrateCamera(world_space_corner_points, arg_image_points, arg_image_size,
+                                 data.cam_matrix, data.dist_coeffs, r_vectors, t_vectors, arg_flags);
+    replace_calibration_model(CalibrationModel::get(data));
+    set_calibrated(true);
+    return rms;
+}
+
+/**
+ * @brief: Undistorts points found in a captured frame to the compensated frame coordinates
+ * @param arg_points Points in the captured frame [px]
+ * @param undistorted Points in the compensated frame [px], may be arg_points
+ * @param arg_size The capture resolution
+ */
+void Camera::undistort_points(const std::vector<cv::Point2f> &arg_points,
+                              std::vector<cv::Point2f> &undistorted, cv::Size arg_size) const
+{
+    if (calibrated == false) {
+        ExceptionMessage em;
+        em.msg = "Cannot undistort points without calibration data";
+        em.id = ExceptionID::no_calibration_data;
+        throw em;
+    }
+    cv::Mat camera_matrix = get_camera_matrix_for_size(arg_size);
+    const cv::Mat& dist_coeffs = calibration_model->get_data().dist_coeffs;
+    undistort_image_points(arg_points, undistorted, camera_matrix, dist_coeffs,
+                           get_new_camera_matrix(camera_matrix, dist_coeffs, arg_size));
+}
+
+/**
+ * @brief: Returns chessboard corners positions in the board plane
+ * @return: corners positions [m], row by row
+ */
+std::vector<cv::Point3f> Camera::get_known_board_positions()
+{
+    std::vector<cv::Point3f> corners;
+    create_known_board_positions(corners);
+    return corners;
 }
 
 /**
@@ -506,14 +1550,14 @@ void Camera::get_chessboard_corners(std::vector<cv::Mat> images,
     for(std::vector<cv::Mat>::iterator iter = images.begin(); iter != images.end(); iter++)
     {
         std::vector<cv::Point2f> point_buf;
-        bool found = findChessboardCorners(*iter, cv::Size(6,9), point_buf,
+        bool found = findChessboardCorners(*iter, chessboard_dimensions, point_buf,
                                            CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_NORMALIZE_IMAGE);
 
         if (found){
             all_found_corners.push_back(point_buf);
         }
         if(show_results){
-            drawChessboardCorners(*iter, cv::Size(6,9), point_buf, found);
+            drawChessboardCorners(*iter, chessboard_dimensions, point_buf, found);
             imshow("Looking for corners", *iter);
             cv::waitKey(0);
         }
@@ -562,29 +1606,9 @@ bool Camera::save_camera_calibration()
     }
     std::ofstream out_stream(camera_calibration_file_name);
     if (out_stream){
-        uint16_t rows = static_cast<uint16_t>(cam_matrix.rows);
-        uint16_t columns = static_cast<uint16_t>(cam_matrix.cols);
-        out_stream << rows << std::endl;
-        out_stream << columns << std::endl;
-        for (int r = 0; r < rows; r++) {
-            for (int c = 0; c < columns; c++) {
-                double value = cam_matrix.at<double>(r, c);
-                out_stream << value << std::endl;
-            }
-        }
-
-        rows = static_cast<uint16_t>(dist_coeffs.rows);
-        columns = static_cast<uint16_t>(dist_coeffs.cols);
-        out_stream << rows << std::endl;
-        out_stream << columns << std::endl;
-        for (int r = 0; r < rows; r++) {
-            for (int c = 0; c < columns; c++) {
-                double value = dist_coeffs.at<double>(r, c);
-                out_stream << value << std::endl;
-            }
-        }
+        bool res = write_calibration_data(out_stream, get_calibration_data());
         out_stream.close();
-        return true;
+        return res;
     }
     return false;
 }
@@ -615,36 +1639,176 @@ void Camera::load_camera_calibration_data()
     }
 
     if (in_stream) {
-        uint16_t rows;
-        uint16_t columns;
-        in_stream >> rows;
-        in_stream >> columns;
-        cam_matrix = cv::Mat(cv::Size(columns, rows), CV_64F);
-        for(int r = 0; r < rows; ++r) {
-            for(int c = 0; c < columns; ++c) {
-                double read = 0.0;
-                in_stream >> read;
-                cam_matrix.at<double>(r,c) = read;
-            }
-        }
-        /// dist_coefficients
-        in_stream >> rows;
-        in_stream >> columns;
-        dist_coeffs = cv::Mat::zeros(rows, columns, CV_64F);
-        for(int r = 0; r < rows; ++r) {
-            for(int c = 0; c < columns; ++c) {
-                double read = 0.0;
-                in_stream >> read;
-                dist_coeffs.at<double>(r,c) = read;
-            }
+        CalibrationData data;
+        in_stream.exceptions(std::ifstream::goodbit);
+        if (read_calibration_data(in_stream, data) == false) {
+            ExceptionMessage em;
+            em.msg = "Exception reading the file named: " + camera_calibration_file_name;
+            em.id = ExceptionID::wrong_calibration_file_name;
+            calibration_in_progress = false;
+            throw em;
         }
         in_stream.close();
+        replace_calibration_model(CalibrationModel::get(data));
         set_calibrated(true);
     }
 }
 
 /**
- * @brief: Show window with raw camera image
+ * @brief: Replaces calibration data without stalling the capture: remap maps for
+ * the active resolution are built on a background thread and the new data is
+ * applied at the next compensation
+ * @param arg_data New calibration data
+ */
+void Camera::reload_calibration(const CalibrationData &arg_data)
+{
+    get_calibration_reloader().request(arg_data);
+}
+
+/**
+ * @brief: Starts watching the calibration file, each change is applied
+ * like with reload_calibration()
+ * @param arg_poll_interval An interval of file modification checks
+ * @return: false when arg_poll_interval is not positive
+ */
+bool Camera::start_calibration_file_watch(std::chrono::milliseconds arg_poll_interval)
+{
+    return get_calibration_reloader().watch_file(camera_calibration_file_name, arg_poll_interval);
+}
+
+/**
+ * @brief: Stops the calibration file watch and background map building,
+ * an update already built is still applied
+ */
+void Camera::stop_calibration_reload()
+{
+    if (calibration_reloader) {
+        calibration_reloader->stop();
+    }
+}
+
+/**
+ * @brief: Starts publishing frames to POSIX shared memory rings "<name>_raw"
+ * and "<name>_compensated", other processes read them with ShmFrameSubscriber.
+ * Rings are created with the first published frame; a stream whose ring cannot
+ * be created then is disabled and counted as shared_memory_export_failure
+ * (see get_error_count()). With lazy compensation
+ * a frame is compensated, and so exported, only when it is requested
+ * (get_frame_calibrated() or the frame pointers), other frames are not exported.
+ * @param arg_name The segment name prefix
+ * @param arg_raw Publish captured frames
+ * @param arg_compensated Publish compensated frames
+ * @param arg_slot_count The number of frames kept in each ring
+ * @param arg_mode The segments permissions, owner only by default
+ * @return: false when the name is empty, no stream is selected, arg_slot_count is 0
+ * or a selected segment already exists (used by another publisher or left by
+ * a crashed one, see ShmFramePublisher::remove())
+ */
+bool Camera::enable_shared_memory_export(const std::string &arg_name, bool arg_raw,
+                                         bool arg_compensated, uint32_t arg_slot_count,
+                                         mode_t arg_mode)
+{
+    if (arg_name.empty() or (arg_raw == false and arg_compensated == false) or arg_slot_count == 0) {
+        return false;
+    }
+    disable_shared_memory_export();
+    if ((arg_raw and ShmFramePublisher::exists(arg_name + "_raw"))
+            or (arg_compensated and ShmFramePublisher::exists(arg_name + "_compensated"))) {
+        return false;
+    }
+    shm_export_name = arg_name;
+    shm_slot_count = arg_slot_count;
+    shm_mode = arg_mode;
+    shm_export_raw = arg_raw;
+    shm_export_compensated = arg_compensated;
+    return true;
+}
+
+/**
+ * @brief: Stops publishing frames and removes the shared memory rings
+ */
+void Camera::disable_shared_memory_export()
+{
+    shm_export_raw = false;
+    shm_export_compensated = false;
+    raw_publisher.close();
+    compensated_publisher.close();
+}
+
+/**
+ * @brief: Check if frames are published to shared memory
+ * @return: shared memory export flag
+ */
+bool Camera::get_shared_memory_export() const
+{
+    return shm_export_raw or shm_export_compensated;
+}
+
+/**
+ * @brief: Returns the calibration reloader, creates it on first use
+ * @return: calibration reloader
+ */
+CalibrationReloader &Camera::get_calibration_reloader()
+{
+    if (!calibration_reloader) {
+        calibration_reloader.reset(new CalibrationReloader(
+            [this](const CalibrationData& data) { prepare_calibration_update(data); }));
+    }
+    return *calibration_reloader;
+}
+
+/**
+ * @brief: Builds remap maps for new calibration data and publishes the update,
+ * runs on the calibration reloader thread
+ * @param data New calibration data
+ */
+void Camera::prepare_calibration_update(const CalibrationData &data)
+{
+    std::shared_ptr<CalibrationUpdate> update = std::make_shared<CalibrationUpdate>();
+    update->model = CalibrationModel::get(data);
+    uint64_t packed_size = active_frame_size.load(std::memory_order_relaxed);
+    cv::Size size(static_cast<int>(packed_size >> 32), static_cast<int>(packed_size & 0xffffffffu));
+    if (size.area() > 0) {
+        /// maps are built in the model, another camera may have built them already
+        try {
+            if (last_correction_type == CorrectionType::remap) {
+                cv::Mat map1, map2;
+                update->model->get_dense_maps(size, map1, map2);
+            } else if (last_correction_type == CorrectionType::remap_compact) {
+                update->model->get_compact_map(size, compact_remap_grid_step, compact_remap_interpolation);
+            }
+        } catch (...) {
+            /// data openCV cannot build maps from is never published
+            return;
+        }
+    }
+    std::atomic_store(&pending_calibration, update);
+    calibration_update_pending.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief: Applies published calibration update, called by the capture thread
+ * before compensation so a frame never sees a partially updated model
+ */
+void Camera::apply_pending_calibration()
+{
+    if (calibration_update_pending.load(std::memory_order_acquire) == false) {
+        return;
+    }
+    calibration_update_pending.store(false, std::memory_order_relaxed);
+    std::shared_ptr<CalibrationUpdate> update =
+            std::atomic_exchange(&pending_calibration, std::shared_ptr<CalibrationUpdate>());
+    if (!update) {
+        return;
+    }
+    replace_calibration_model(update->model);
+    set_calibrated(true);
+    ++calibration_version;
+}
+
+/**
+ * @brief: Show window with raw camera image (blocking, DisplayService
+ * shows frames without stalling the capture loop)
  */
 void Camera::show_frame_raw() const
 {
@@ -658,7 +1822,8 @@ void Camera::show_frame_raw() const
 }
 
 /**
- * @brief: Show window with compensated camera image
+ * @brief: Show window with compensated camera image (blocking, DisplayService
+ * shows frames without stalling the capture loop)
  */
 void Camera::show_frame_compensated() const
 {
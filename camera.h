@@ -9,8 +9,22 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
+#include "calibration_data.h"
+#include "calibration_model.h"
+#include "calibration_reloader.h"
+#include "coarse_remap.h"
+#include "distortion_model.h"
+#include "frame_source.h"
+#include "shm_frame_ring.h"
 
 /**
  * @namespace camera_ns
@@ -23,11 +37,24 @@ namespace camera_ns {
      */
     enum class CorrectionType {
         remap,
+        remap_compact,
         undistort
     };
 
     /**
-     * @brief The ExceptionID enum
+     * @brief The CorrectionQuality enum to describe the correction quality
+     * level chosen in deadline mode, from the best to the cheapest one
+     */
+    enum class CorrectionQuality {
+        full,
+        nearest,
+        reduced_resolution,
+        alternate_frames
+    };
+
+    /**
+     * @brief The ExceptionID enum, also used as a status
+     * returned by the non-throwing per-frame calls
      */
     enum class ExceptionID {
         camera_open_failure,
@@ -41,9 +68,18 @@ namespace camera_ns {
         wrong_chessboard_square_dimension,
         wrong_calibration_file_name,
         empty_calibration_file_name,
-        empty_frame
+        empty_frame,
+        calibration_resolution_mismatch,
+        correction_failure,
+        shared_memory_export_failure,
+        ok
     };
 
+    /**
+     * @brief Number of ExceptionID failure values (ok has to stay the last one)
+     */
+    const size_t exception_id_count = static_cast<size_t>(ExceptionID::ok);
+
     /**
      * @brief The ExceptionMessage struct to define the exception
      * thown by camera class
@@ -53,6 +89,20 @@ namespace camera_ns {
         ExceptionID id;
     };
 
+    /**
+     * @brief BandHandler is called by Camera::compensate_streaming with each
+     * compensated band of rows and the index of its first row
+     */
+    typedef std::function<void(const cv::Mat& band, int first_row)> BandHandler;
+
+    /**
+     * @brief The CalibrationUpdate struct to keep new calibration model with
+     * remap maps prebuilt in the background, waiting to be applied at a frame boundary
+     */
+    struct CalibrationUpdate {
+        std::shared_ptr<const CalibrationModel> model;
+    };
+
     /**
      * @brief The Camera class
      */
@@ -71,6 +121,15 @@ namespace camera_ns {
         bool set_calibrated(bool arg_calibrated);
         bool set_number_of_images_to_calibrate(uint8_t atg_num);
         bool set_default_camera_calibration_coefs();
+        bool set_calibration_frame_size(cv::Size arg_size);
+        bool set_capture_resolution(cv::Size arg_size);
+        bool set_compact_remap_grid(int arg_grid_step, GridInterpolation arg_interpolation);
+        bool set_lazy_compensation(bool arg_lazy);
+        bool set_duplicate_frame_skipping(bool arg_skipping);
+        bool set_duplicate_frame_hashing(bool arg_hashing);
+        bool set_frame_budget(std::chrono::microseconds arg_budget);
+        bool set_distortion_model(DistortionModel arg_model);
+        bool set_calibration_model(std::shared_ptr<const CalibrationModel> arg_model);
 
         bool get_calibration_in_progress() const;
         bool get_calibrated() const;
@@ -82,28 +141,95 @@ namespace camera_ns {
         std::string get_camera_calibration_results_file_name() const;
         cv::Size get_chessboard_dimensions() const;
         cv::Mat get_frame_raw() const;
-        cv::Mat get_frame_calibrated() const;
+        cv::Mat get_frame_calibrated();
         cv::Mat get_camera_matrix() const;
         cv::Mat get_dist_coefs() const;
+        cv::Mat get_camera_matrix_for_size(cv::Size arg_size) const;
+        cv::Size get_calibration_frame_size() const;
+        size_t get_remap_cache_size() const;
+        CalibrationData get_calibration_data() const;
+        std::shared_ptr<const CalibrationModel> get_calibration_model() const;
+        uint64_t get_calibration_version() const;
+        bool get_calibration_update_pending() const;
+        bool get_lazy_compensation() const;
+        bool get_duplicate_frame_skipping() const;
+        bool get_duplicate_frame_hashing() const;
+        bool get_last_frame_duplicate() const;
+        uint64_t get_capture_sequence() const;
+        uint64_t get_duplicate_frames_count() const;
+        uint64_t get_skipped_compensations_count() const;
+        uint64_t get_dropped_compensations_count() const;
+        std::chrono::microseconds get_frame_budget() const;
+        CorrectionQuality get_correction_quality() const;
+        double get_correction_cost() const;
+        DistortionModel get_distortion_model() const;
+        int get_compact_remap_grid_step() const;
+        GridInterpolation get_compact_remap_interpolation() const;
+        float get_compact_remap_max_error(cv::Size arg_size);
+        uint64_t get_error_count(ExceptionID arg_id) const;
         cv::Mat* get_pointer_to_frame_raw();
         cv::Mat* get_pointer_to_frame_calibrated();
         cv::Mat& get_reference_to_frame_raw();
         cv::Mat& get_reference_to_frame_calibrated();
 
         void calibrate();
+        double calibrate_from_image_points(const std::vector<std::vector<cv::Point2f>>& arg_image_points,
+                                           cv::Size arg_image_size);
+        double calibrate_from_image_points(const std::vector<std::vector<cv::Point2f>>& arg_image_points,
+                                           cv::Size arg_image_size, int arg_flags);
+        void undistort_points(const std::vector<cv::Point2f>& arg_points,
+                              std::vector<cv::Point2f>& undistorted, cv::Size arg_size) const;
+        std::vector<cv::Point3f> get_known_board_positions();
         void compensate_distortions(CorrectionType ct);
+        bool compensate_streaming(IncrementalFrameSource& source, const BandHandler& handler,
+                                  int band_rows = 32);
         void load_camera_calibration_data();
+        void clear_remap_cache();
+        void reload_calibration(const CalibrationData& arg_data);
+        bool start_calibration_file_watch(std::chrono::milliseconds arg_poll_interval);
+        void stop_calibration_reload();
+        bool enable_shared_memory_export(const std::string& arg_name, bool arg_raw,
+                                         bool arg_compensated, uint32_t arg_slot_count = 4,
+                                         mode_t arg_mode = 0600);
+        void disable_shared_memory_export();
+        bool get_shared_memory_export() const;
+        void reset_error_counters();
         void show_frame_raw() const;
         void show_frame_compensated() const;
         bool open();
         bool read();
+        ExceptionID try_read() noexcept;
+        ExceptionID try_compensate_distortions(CorrectionType ct) noexcept;
 
     private:
         bool chessboard_found;
         bool calibration_in_progress;
+        DistortionModel distortion_model;
         bool calibrated;
-        bool remap_first_entry;
+        bool lazy_compensation;
+        bool compensation_requested;
+        bool duplicate_frame_skipping;
+        bool duplicate_frame_hashing;
+        bool last_frame_duplicate;
+        bool alternate_frame_skip;
+        int quality_settle_frames;
+        int quality_headroom_frames;
+        CorrectionQuality correction_quality;
+        std::chrono::microseconds frame_budget;
+        double correction_cost_us;
         int camera_id;
+        std::atomic<int> compact_remap_grid_step;
+        std::atomic<GridInterpolation> compact_remap_interpolation;
+        std::atomic<CorrectionType> last_correction_type;
+        CorrectionType requested_correction_type;
+        CorrectionType compensated_correction_type;
+        uint64_t capture_sequence;
+        uint64_t compensated_sequence;
+        uint64_t duplicate_frames_count;
+        uint64_t skipped_compensations_count;
+        uint64_t dropped_compensations_count;
+        uint64_t last_frame_hash;
+        double last_frame_timestamp;
         float chessboard_square_dimension;
         uint8_t chessboard_width;
         uint8_t chessboard_height;
@@ -114,12 +240,32 @@ namespace camera_ns {
         cv::Size chessboard_dimensions;
         cv::VideoCapture cam;
         cv::Mat captured_frame;
-        cv::Mat cam_matrix;
-        cv::Mat dist_coeffs;
         cv::Mat frame_compensated;
+        cv::Mat frame_reduced;
+        cv::Mat streamed_frame;
+        cv::Mat streamed_compensated;
+        std::future<void> reduced_maps_build;
+        std::weak_ptr<const CalibrationModel> reduced_maps_model;
+        cv::Size reduced_maps_size;
+        CorrectionType reduced_maps_type;
         cv::Mat remap_map1;
         cv::Mat remap_map2;
         cv::Size frame_size;
+        std::shared_ptr<const CalibrationModel> calibration_model;
+        std::shared_ptr<const CoarseRemapMap> compact_remap_map;
+        std::array<uint64_t, exception_id_count> error_counters;
+        std::atomic<uint64_t> active_frame_size;
+        std::atomic<uint64_t> calibration_version;
+        std::atomic<bool> calibration_update_pending;
+        std::shared_ptr<CalibrationUpdate> pending_calibration;
+        std::unique_ptr<CalibrationReloader> calibration_reloader;
+        std::string shm_export_name;
+        uint32_t shm_slot_count;
+        mode_t shm_mode;
+        bool shm_export_raw;
+        bool shm_export_compensated;
+        ShmFramePublisher raw_publisher;
+        ShmFramePublisher compensated_publisher;
 
         void calibration_backend(std::vector<cv::Mat> calibration_images);
         void get_chessboard_corners(std::vector<cv::Mat> images,
@@ -128,6 +274,27 @@ namespace camera_ns {
         void create_known_board_positions(std::vector<cv::Point3f> &corners);
         void put_calibration_info_on_image(cv::Mat& image);
         bool save_camera_calibration();
+        bool select_remap_maps(cv::Size arg_size);
+        bool select_compact_remap_map(cv::Size arg_size);
+        void replace_calibration_model(std::shared_ptr<const CalibrationModel> arg_model);
+        ExceptionMessage make_resolution_mismatch(cv::Size arg_size) const;
+        void set_frame_size(cv::Size arg_size);
+        void prepare_calibration_update(const CalibrationData& data);
+        void apply_pending_calibration();
+        CalibrationReloader& get_calibration_reloader();
+        ExceptionID compensate_frame(CorrectionType ct);
+        ExceptionID request_compensation(CorrectionType ct);
+        ExceptionID compensate_current_frame(CorrectionType ct);
+        void resolve_lazy_compensation();
+        void register_captured_frame(bool arg_device_timestamp);
+        int wait_for_rows(IncrementalFrameSource& source, cv::Mat& frame, int rows_ready, int rows_needed);
+        void export_frame(ShmFramePublisher& publisher, const std::string& suffix, const cv::Mat& frame,
+                          bool& export_enabled);
+        ExceptionID correct(CorrectionType ct, const cv::Mat& source, RemapInterpolation interpolation);
+        void update_correction_quality(double cost_us);
+        void prebuild_reduced_maps(CorrectionType ct);
+        bool get_reduced_maps_ready(CorrectionType ct);
+        ExceptionID count_status(ExceptionID status) noexcept;
     };
 }
 
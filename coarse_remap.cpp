@@ -0,0 +1,278 @@
+/**
+  @file coarse_remap.cpp
+  @brief A definitions of compact remap maps stored on a coarse grid
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "coarse_remap.h"
+#include "distortion_model.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: Linear interpolation weights
+ */
+static inline void linear_weights(float t, float* w)
+{
+    w[0] = 1.0f - t;
+    w[1] = t;
+}
+
+/**
+ * @brief: Catmull-Rom interpolation weights, the curve passes through the nodes
+ */
+static inline void cubic_weights(float t, float* w)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    w[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+    w[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    w[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    w[3] = 0.5f * (t3 - t2);
+}
+
+/**
+ * @brief: A default constructor
+ */
+CoarseRemapMap::CoarseRemapMap()
+    : grid_step(0), inv_grid_step(0.0f), interpolation(GridInterpolation::bilinear)
+{
+}
+
+/**
+ * @brief: Computes source coordinates of grid nodes
+ * @param camera_matrix a camera matrix valid for arg_size
+ * @param dist_coeffs distortion coefficients
+ * @param new_camera_matrix a camera matrix of the compensated image
+ * @param arg_size a size of the compensated image
+ * @param arg_grid_step a distance between grid nodes [px]
+ * @param arg_interpolation an interpolation between grid nodes
+ */
+void CoarseRemapMap::build(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                           const cv::Mat &new_camera_matrix, cv::Size arg_size,
+                           int arg_grid_step, GridInterpolation arg_interpolation)
+{
+    output_size = arg_size;
+    grid_step = std::max(arg_grid_step, 1);
+    inv_grid_step = 1.0f / static_cast<float>(grid_step);
+    interpolation = arg_interpolation;
+
+    const int nodes_x = (arg_size.width - 1) / grid_step + 1 + grid_padding_before + grid_padding_after;
+    const int nodes_y = (arg_size.height - 1) / grid_step + 1 + grid_padding_before + grid_padding_after;
+    const double fx = new_camera_matrix.at<double>(0, 0);
+    const double fy = new_camera_matrix.at<double>(1, 1);
+    const double cx = new_camera_matrix.at<double>(0, 2);
+    const double cy = new_camera_matrix.at<double>(1, 2);
+
+    /// grid nodes are undistorted pixels, projecting them gives the source pixels
+    std::vector<cv::Point2d> normalized_points;
+    normalized_points.reserve(static_cast<size_t>(nodes_x * nodes_y));
+    for (int gy = 0; gy < nodes_y; ++gy) {
+        const double v = static_cast<double>((gy - grid_padding_before) * grid_step);
+        for (int gx = 0; gx < nodes_x; ++gx) {
+            const double u = static_cast<double>((gx - grid_padding_before) * grid_step);
+            normalized_points.push_back(cv::Point2d((u - cx) / fx, (v - cy) / fy));
+        }
+    }
+    std::vector<cv::Point2f> image_points;
+    distort_normalized_points(camera_matrix, dist_coeffs, normalized_points, image_points);
+
+    grid.create(nodes_y, nodes_x, CV_32FC2);
+    for (int gy = 0; gy < nodes_y; ++gy) {
+        float* row = grid.ptr<float>(gy);
+        for (int gx = 0; gx < nodes_x; ++gx) {
+            const cv::Point2f& p = image_points[static_cast<size_t>(gy * nodes_x + gx)];
+            row[2 * gx] = p.x;
+            row[2 * gx + 1] = p.y;
+        }
+    }
+}
+
+/**
+ * @brief: Check if the map was built
+ * @return: true when there is no grid
+ */
+bool CoarseRemapMap::empty() const
+{
+    return grid.empty();
+}
+
+/**
+ * @brief: Returns the size of the compensated image
+ * @return: output size
+ */
+cv::Size CoarseRemapMap::size() const
+{
+    return output_size;
+}
+
+/**
+ * @brief: Returns the distance between grid nodes
+ * @return: grid step [px]
+ */
+int CoarseRemapMap::get_grid_step() const
+{
+    return grid_step;
+}
+
+/**
+ * @brief: Returns the interpolation used between grid nodes
+ * @return: grid interpolation
+ */
+GridInterpolation CoarseRemapMap::get_interpolation() const
+{
+    return interpolation;
+}
+
+/**
+ * @brief: Returns the memory used by the grid
+ * @return: grid size [B]
+ */
+size_t CoarseRemapMap::get_memory_size() const
+{
+    return grid.total() * grid.elemSize();
+}
+
+/**
+ * @brief: Interpolates grid columns at a destination row
+ * @param y a destination row
+ * @param node_x an output buffer for x coordinates of all grid columns
+ * @param node_y an output buffer for y coordinates of all grid columns
+ */
+void CoarseRemapMap::interpolate_grid_row(int y, float *node_x, float *node_y) const
+{
+    const int cell = y / grid_step;
+    const float t = static_cast<float>(y - cell * grid_step) * inv_grid_step;
+    if (interpolation == GridInterpolation::bicubic) {
+        float w[4];
+        cubic_weights(t, w);
+        const float* r0 = grid.ptr<float>(cell);
+        const float* r1 = grid.ptr<float>(cell + 1);
+        const float* r2 = grid.ptr<float>(cell + 2);
+        const float* r3 = grid.ptr<float>(cell + 3);
+        for (int gx = 0; gx < grid.cols; ++gx) {
+            node_x[gx] = w[0] * r0[2 * gx] + w[1] * r1[2 * gx] + w[2] * r2[2 * gx] + w[3] * r3[2 * gx];
+            node_y[gx] = w[0] * r0[2 * gx + 1] + w[1] * r1[2 * gx + 1]
+                    + w[2] * r2[2 * gx + 1] + w[3] * r3[2 * gx + 1];
+        }
+    } else {
+        float w[2];
+        linear_weights(t, w);
+        const float* r0 = grid.ptr<float>(cell + grid_padding_before);
+        const float* r1 = grid.ptr<float>(cell + grid_padding_before + 1);
+        for (int gx = 0; gx < grid.cols; ++gx) {
+            node_x[gx] = w[0] * r0[2 * gx] + w[1] * r1[2 * gx];
+            node_y[gx] = w[0] * r0[2 * gx + 1] + w[1] * r1[2 * gx + 1];
+        }
+    }
+}
+
+/**
+ * @brief: Interpolates source coordinates of single destination row
+ * @param y a destination row
+ * @param src_x an output buffer for source x coordinates
+ * @param src_y an output buffer for source y coordinates
+ */
+void CoarseRemapMap::fill_row(int y, float *src_x, float *src_y) const
+{
+    thread_local std::vector<float> nodes;
+    nodes.resize(static_cast<size_t>(2 * grid.cols));
+    float* node_x = nodes.data();
+    float* node_y = node_x + grid.cols;
+    interpolate_grid_row(y, node_x, node_y);
+
+    if (interpolation == GridInterpolation::bicubic) {
+        for (int x = 0; x < output_size.width; ++x) {
+            const int cell = x / grid_step;
+            float w[4];
+            cubic_weights(static_cast<float>(x - cell * grid_step) * inv_grid_step, w);
+            src_x[x] = w[0] * node_x[cell] + w[1] * node_x[cell + 1]
+                    + w[2] * node_x[cell + 2] + w[3] * node_x[cell + 3];
+            src_y[x] = w[0] * node_y[cell] + w[1] * node_y[cell + 1]
+                    + w[2] * node_y[cell + 2] + w[3] * node_y[cell + 3];
+        }
+    } else {
+        for (int x = 0; x < output_size.width; ++x) {
+            const int cell = x / grid_step + grid_padding_before;
+            const float t = static_cast<float>(x % grid_step) * inv_grid_step;
+            src_x[x] = node_x[cell] + t * (node_x[cell + 1] - node_x[cell]);
+            src_y[x] = node_y[cell] + t * (node_y[cell + 1] - node_y[cell]);
+        }
+    }
+}
+
+/**
+ * @brief: Expands the grid into dense CV_32FC1 maps
+ * @param map_x an output map with source x coordinates
+ * @param map_y an output map with source y coordinates
+ */
+void CoarseRemapMap::expand(cv::Mat &map_x, cv::Mat &map_y) const
+{
+    map_x.create(output_size, CV_32FC1);
+    map_y.create(output_size, CV_32FC1);
+    for (int y = 0; y < output_size.height; ++y) {
+        fill_row(y, map_x.ptr<float>(y), map_y.ptr<float>(y));
+    }
+}
+
+/**
+ * @brief: Measures the maximal distance between interpolated and dense source
+ * coordinates. Fixed-point dense maps are quantized to 1/32 px themselves.
+ * @param dense_map1 a dense map (CV_16SC2, CV_32FC2 or CV_32FC1)
+ * @param dense_map2 a second dense map (CV_16UC1, CV_32FC1 or empty)
+ * @return: maximal error [px]
+ */
+float CoarseRemapMap::max_error(const cv::Mat &dense_map1, const cv::Mat &dense_map2) const
+{
+    std::vector<float> coarse_x(static_cast<size_t>(output_size.width));
+    std::vector<float> coarse_y(static_cast<size_t>(output_size.width));
+    std::vector<float> dense_x(static_cast<size_t>(output_size.width));
+    std::vector<float> dense_y(static_cast<size_t>(output_size.width));
+    const bool fixed_point = dense_map1.type() == CV_16SC2;
+    FixedPointMapSampler fixed_sampler(dense_map1, dense_map2);
+    FloatMapSampler float_sampler(dense_map1, dense_map2);
+
+    float error = 0.0f;
+    for (int y = 0; y < output_size.height; ++y) {
+        fill_row(y, coarse_x.data(), coarse_y.data());
+        if (fixed_point) {
+            fixed_sampler.fill_row(y, dense_x.data(), dense_y.data());
+        } else {
+            float_sampler.fill_row(y, dense_x.data(), dense_y.data());
+        }
+        for (int x = 0; x < output_size.width; ++x) {
+            const float dx = coarse_x[x] - dense_x[x];
+            const float dy = coarse_y[x] - dense_y[x];
+            error = std::max(error, std::sqrt(dx * dx + dy * dy));
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief: Remaps whole frame interpolating the coarse grid on the fly
+ * @param src a source frame
+ * @param dst a destination frame
+ * @param map a coarse map
+ * @param interpolation a sampling method
+ * @return: false when src type is not supported, the caller should then
+ * expand the map and fall back to cv::remap
+ */
+bool camera_ns::remap_frame(const cv::Mat &src, cv::Mat &dst, const CoarseRemapMap &map,
+                            RemapInterpolation interpolation)
+{
+    if (src.empty() || map.empty() || is_remap_type_supported(src.type()) == false) {
+        return false;
+    }
+    if (dst.data == src.data) {
+        dst = cv::Mat();
+    }
+    dst.create(map.size(), src.type());
+    return remap_rows(src, dst, map, interpolation, cv::Range(0, map.size().height));
+}
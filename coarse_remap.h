@@ -0,0 +1,65 @@
+/**
+  @file coarse_remap.h
+  @brief A declarations of compact remap maps stored on a coarse grid
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef COARSE_REMAP_H
+#define COARSE_REMAP_H
+
+#include <opencv2/core.hpp>
+#include "remap_kernels.h"
+
+namespace camera_ns {
+    /**
+     * @brief The GridInterpolation enum to chose how source coordinates
+     * are interpolated between coarse grid nodes
+     */
+    enum class GridInterpolation {
+        bilinear,
+        bicubic
+    };
+
+    /**
+     * @brief The CoarseRemapMap class keeps the undistortion mapping only on
+     * grid nodes every grid_step pixels and interpolates source coordinates
+     * of the pixels in between while remapping. It is a map sampler for
+     * remap_rows().
+     */
+    class CoarseRemapMap
+    {
+    public:
+        CoarseRemapMap();
+        void build(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                   const cv::Mat& new_camera_matrix, cv::Size arg_size,
+                   int arg_grid_step, GridInterpolation arg_interpolation);
+        bool empty() const;
+        cv::Size size() const;
+        int get_grid_step() const;
+        GridInterpolation get_interpolation() const;
+        size_t get_memory_size() const;
+
+        void fill_row(int y, float* src_x, float* src_y) const;
+        void expand(cv::Mat& map_x, cv::Mat& map_y) const;
+        float max_error(const cv::Mat& dense_map1, const cv::Mat& dense_map2) const;
+
+    private:
+        /// grid has one node of padding before and two after the image
+        static const int grid_padding_before = 1;
+        static const int grid_padding_after = 2;
+        cv::Mat grid;
+        cv::Size output_size;
+        int grid_step;
+        float inv_grid_step;
+        GridInterpolation interpolation;
+
+        void interpolate_grid_row(int y, float* node_x, float* node_y) const;
+    };
+
+    bool remap_frame(const cv::Mat& src, cv::Mat& dst, const CoarseRemapMap& map,
+                     RemapInterpolation interpolation);
+}
+
+#endif // COARSE_REMAP_H
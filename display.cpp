@@ -0,0 +1,351 @@
+/**
+  @file display.cpp
+  @brief A definitions of display service showing camera frames off the capture thread
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <chrono>
+#include <opencv2/core.hpp>
+#include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
+#include "display.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: A default constructor
+ */
+FrameMailbox::FrameMailbox()
+    : write_index(0), read_index(1), middle_index(2)
+{
+}
+
+/**
+ * @brief: Copies frames into the write slot and publishes it, never blocks
+ * @param raw a raw frame
+ * @param compensated a compensated frame (can be empty)
+ */
+void FrameMailbox::post(const cv::Mat &raw, const cv::Mat &compensated)
+{
+    /// slot buffers are reused, copyTo allocates only when frame size changes
+    raw.copyTo(slots[write_index].raw);
+    if (compensated.empty()) {
+        slots[write_index].compensated.release();
+    } else {
+        compensated.copyTo(slots[write_index].compensated);
+    }
+    int previous = middle_index.exchange(write_index | fresh_flag, std::memory_order_acq_rel);
+    write_index = previous & index_mask;
+}
+
+/**
+ * @brief: Takes the latest posted frames. The returned frames share the slot
+ * buffers and stay valid until the next take()
+ * @param raw a raw frame
+ * @param compensated a compensated frame
+ * @return: false when nothing new was posted since the last take
+ */
+bool FrameMailbox::take(cv::Mat &raw, cv::Mat &compensated)
+{
+    if ((middle_index.load(std::memory_order_acquire) & fresh_flag) == 0) {
+        return false;
+    }
+    int previous = middle_index.exchange(read_index, std::memory_order_acq_rel);
+    read_index = previous & index_mask;
+    raw = slots[read_index].raw;
+    compensated = slots[read_index].compensated;
+    return true;
+}
+
+/**
+ * @brief: A default destructor
+ */
+DisplayBackend::~DisplayBackend()
+{
+
+}
+
+/**
+ * @brief: Shows frame in HighGUI window
+ * @param window_name a window name
+ * @param frame a frame to show
+ */
+void HighGuiDisplayBackend::show(const std::string &window_name, const cv::Mat &frame)
+{
+    cv::imshow(window_name, frame);
+}
+
+/**
+ * @brief: Processes HighGUI events
+ * @return: code of pressed key or -1
+ */
+int HighGuiDisplayBackend::poll_key()
+{
+    return cv::waitKey(1);
+}
+
+/**
+ * @brief: Closes all HighGUI windows
+ */
+void HighGuiDisplayBackend::close()
+{
+    cv::destroyAllWindows();
+}
+
+/**
+ * @brief: Drops the frame
+ */
+void NullDisplayBackend::show(const std::string &window_name, const cv::Mat &frame)
+{
+    (void)window_name;
+    (void)frame;
+}
+
+/**
+ * @brief: No key can be pressed in headless mode
+ * @return: -1
+ */
+int NullDisplayBackend::poll_key()
+{
+    return -1;
+}
+
+/**
+ * @brief: Nothing to close in headless mode
+ */
+void NullDisplayBackend::close()
+{
+
+}
+
+/**
+ * @brief: Creates display backend for the build: NullDisplayBackend when
+ * CAMERA_HEADLESS is defined, HighGuiDisplayBackend otherwise
+ * @return: display backend
+ */
+std::unique_ptr<DisplayBackend> camera_ns::make_default_display_backend()
+{
+#ifdef CAMERA_HEADLESS
+    return std::unique_ptr<DisplayBackend>(new NullDisplayBackend());
+#else
+    return std::unique_ptr<DisplayBackend>(new HighGuiDisplayBackend());
+#endif
+}
+
+/**
+ * @brief: A default constructor, uses the default backend for the build
+ */
+DisplayService::DisplayService()
+    : DisplayService(make_default_display_backend())
+{
+}
+
+/**
+ * @brief: A constructor
+ * @param arg_backend a backend used to show frames
+ */
+DisplayService::DisplayService(std::unique_ptr<DisplayBackend> arg_backend)
+    : backend(std::move(arg_backend)), running(false), last_key(-1),
+      shown_frames_count(0), refresh_period_us(0)
+{
+    set_max_refresh_rate(30.0);
+    set_window_name("Camera");
+}
+
+/**
+ * @brief: A destructor, stops the display thread
+ */
+DisplayService::~DisplayService()
+{
+    stop();
+}
+
+/**
+ * @brief: Sets the maximal number of window refreshes per second
+ * @param arg_fps refresh rate [Hz]
+ * @return: false when arg_fps is not positive
+ */
+bool DisplayService::set_max_refresh_rate(double arg_fps)
+{
+    if (arg_fps <= 0.0) {
+        return false;
+    }
+    refresh_period_us = static_cast<int64_t>(1e6 / arg_fps);
+    return true;
+}
+
+/**
+ * @brief: Sets the window name, should be called before start()
+ * @param arg_window_name a window name
+ * @return: true
+ */
+bool DisplayService::set_window_name(std::string arg_window_name)
+{
+    window_name = arg_window_name;
+    return true;
+}
+
+/**
+ * @brief: Returns the maximal number of window refreshes per second
+ * @return: refresh rate [Hz]
+ */
+double DisplayService::get_max_refresh_rate() const
+{
+    return 1e6 / static_cast<double>(refresh_period_us.load());
+}
+
+/**
+ * @brief: Returns the window name
+ * @return: window name
+ */
+std::string DisplayService::get_window_name() const
+{
+    return window_name;
+}
+
+/**
+ * @brief: Check if the display thread is running
+ * @return: running flag
+ */
+bool DisplayService::get_running() const
+{
+    return running;
+}
+
+/**
+ * @brief: Returns the last key pressed in the window and clears it
+ * @return: key code or -1 when no key was pressed
+ */
+int DisplayService::get_last_key()
+{
+    return last_key.exchange(-1);
+}
+
+/**
+ * @brief: Returns number of composites shown since start
+ * @return: shown frames count
+ */
+uint64_t DisplayService::get_shown_frames_count() const
+{
+    return shown_frames_count;
+}
+
+/**
+ * @brief: Starts the display thread
+ */
+void DisplayService::start()
+{
+    if (running) {
+        return;
+    }
+    running = true;
+    next_refresh = std::chrono::steady_clock::now();
+    worker = std::thread(&DisplayService::run, this);
+}
+
+/**
+ * @brief: Stops the display thread and closes windows
+ */
+void DisplayService::stop()
+{
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    } else {
+        /// windows shown by refresh() are closed on the calling thread
+        backend->close();
+    }
+}
+
+/**
+ * @brief: Shows the latest posted frames when the refresh period has passed and
+ * processes window events, on the calling thread. Used from the main loop
+ * instead of start(), returns at once when it is not time to refresh yet.
+ * @return: false when nothing was shown or the display thread is running
+ */
+bool DisplayService::refresh()
+{
+    if (running or std::chrono::steady_clock::now() < next_refresh) {
+        return false;
+    }
+    return update();
+}
+
+/**
+ * @brief: Posts frames to show, called from the capture thread. It only copies
+ * the frames, the latest frames are shown at the next refresh
+ * @param raw a raw frame
+ * @param compensated a compensated frame (can be empty)
+ */
+void DisplayService::post(const cv::Mat &raw, const cv::Mat &compensated)
+{
+    if (raw.empty()) {
+        return;
+    }
+    mailbox.post(raw, compensated);
+}
+
+/**
+ * @brief: The display thread loop
+ */
+void DisplayService::run()
+{
+    while (running) {
+        std::this_thread::sleep_until(next_refresh);
+        update();
+    }
+    backend->close();
+}
+
+/**
+ * @brief: Schedules the next refresh, shows the latest posted frames and
+ * processes window events
+ * @return: true when frames were shown
+ */
+bool DisplayService::update()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    next_refresh += std::chrono::microseconds(refresh_period_us.load());
+    if (next_refresh < now) {
+        /// do not try to catch up missed refreshes
+        next_refresh = now + std::chrono::microseconds(refresh_period_us.load());
+    }
+    bool shown = mailbox.take(shown_raw, shown_compensated);
+    if (shown) {
+        show(shown_raw, shown_compensated);
+        ++shown_frames_count;
+    }
+    int key = backend->poll_key();
+    if (key >= 0) {
+        last_key = key;
+    }
+    return shown;
+}
+
+/**
+ * @brief: Composites raw and compensated frames side by side and shows them
+ * @param raw a raw frame
+ * @param compensated a compensated frame (can be empty)
+ */
+void DisplayService::show(const cv::Mat &raw, const cv::Mat &compensated)
+{
+    if (compensated.empty()) {
+        backend->show(window_name, raw);
+        return;
+    }
+    if (compensated.type() != raw.type()) {
+        backend->show(window_name + " raw", raw);
+        backend->show(window_name + " compensated", compensated);
+        return;
+    }
+    cv::Mat right = compensated;
+    if (compensated.rows != raw.rows) {
+        int width = compensated.cols * raw.rows / compensated.rows;
+        cv::resize(compensated, right, cv::Size(width, raw.rows), 0, 0, cv::INTER_NEAREST);
+    }
+    cv::hconcat(raw, right, composite);
+    backend->show(window_name, composite);
+}
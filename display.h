@@ -0,0 +1,134 @@
+/**
+  @file display.h
+  @brief A declarations of display service showing camera frames off the capture thread
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <opencv2/core.hpp>
+
+namespace camera_ns {
+    /**
+     * @brief The FrameMailbox class keeps the latest raw and compensated frames
+     * posted by a capture thread. It is a lock-free triple buffer for single
+     * producer and single consumer: post() never waits for the reader and
+     * older frames which were not taken are overwritten.
+     */
+    class FrameMailbox
+    {
+    public:
+        FrameMailbox();
+        void post(const cv::Mat& raw, const cv::Mat& compensated);
+        bool take(cv::Mat& raw, cv::Mat& compensated);
+
+    private:
+        /**
+         * @brief The Slot struct keeps a single pair of frames
+         */
+        struct Slot {
+            cv::Mat raw;
+            cv::Mat compensated;
+        };
+
+        static const int fresh_flag = 4;
+        static const int index_mask = 3;
+        Slot slots[3];
+        int write_index;
+        int read_index;
+        std::atomic<int> middle_index;
+    };
+
+    /**
+     * @brief The DisplayBackend class is an interface of the windowing system
+     * used by DisplayService. All calls are made from the display thread.
+     */
+    class DisplayBackend
+    {
+    public:
+        virtual ~DisplayBackend();
+        virtual void show(const std::string& window_name, const cv::Mat& frame) = 0;
+        virtual int poll_key() = 0;
+        virtual void close() = 0;
+    };
+
+    /**
+     * @brief The HighGuiDisplayBackend class shows frames with openCV HighGUI
+     */
+    class HighGuiDisplayBackend : public DisplayBackend
+    {
+    public:
+        void show(const std::string& window_name, const cv::Mat& frame) override;
+        int poll_key() override;
+        void close() override;
+    };
+
+    /**
+     * @brief The NullDisplayBackend class drops all frames, used in headless builds
+     */
+    class NullDisplayBackend : public DisplayBackend
+    {
+    public:
+        void show(const std::string& window_name, const cv::Mat& frame) override;
+        int poll_key() override;
+        void close() override;
+    };
+
+    std::unique_ptr<DisplayBackend> make_default_display_backend();
+
+    /**
+     * @brief The DisplayService class shows raw and compensated frames side by side
+     * with a limited refresh rate, on its own thread (start()) or on the thread
+     * calling refresh(). HighGUI windows can only be used from the main thread
+     * on macOS, so there refresh() has to be called from the main loop instead of start().
+     */
+    class DisplayService
+    {
+    public:
+        DisplayService();
+        explicit DisplayService(std::unique_ptr<DisplayBackend> arg_backend);
+        ~DisplayService();
+        bool set_max_refresh_rate(double arg_fps);
+        bool set_window_name(std::string arg_window_name);
+
+        double get_max_refresh_rate() const;
+        std::string get_window_name() const;
+        bool get_running() const;
+        int get_last_key();
+        uint64_t get_shown_frames_count() const;
+
+        void start();
+        void stop();
+        bool refresh();
+        void post(const cv::Mat& raw, const cv::Mat& compensated);
+
+    private:
+        std::unique_ptr<DisplayBackend> backend;
+        FrameMailbox mailbox;
+        std::thread worker;
+        std::atomic<bool> running;
+        std::atomic<int> last_key;
+        std::atomic<uint64_t> shown_frames_count;
+        std::atomic<int64_t> refresh_period_us;
+        std::chrono::steady_clock::time_point next_refresh;
+        std::string window_name;
+        cv::Mat shown_raw;
+        cv::Mat shown_compensated;
+        cv::Mat composite;
+
+        void run();
+        bool update();
+        void show(const cv::Mat& raw, const cv::Mat& compensated);
+    };
+}
+
+#endif // DISPLAY_H
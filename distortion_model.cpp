@@ -0,0 +1,381 @@
+/**
+  @file distortion_model.cpp
+  @brief Distortion-model specialized evaluators used for map generation and point undistortion
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include "distortion_model.h"
+
+
+using namespace camera_ns;
+
+/// openCV undistortPoints uses the same number of fixed-point iterations
+static const int undistort_iterations = 5;
+
+/**
+ * @brief The UndistortMapBody class fills a band of undistortion map rows
+ * with a model specialized evaluator; used with cv::parallel_for_
+ */
+template <DistortionModel M>
+class UndistortMapBody : public cv::ParallelLoopBody
+{
+public:
+    UndistortMapBody(const DistortionCoeffs& arg_coeffs, const cv::Mat& camera_matrix,
+                     const cv::Mat& new_camera_matrix, cv::Mat& arg_map1, cv::Mat& arg_map2)
+        : coeffs(arg_coeffs), map1(arg_map1), map2(arg_map2),
+          fx(camera_matrix.at<double>(0, 0)), fy(camera_matrix.at<double>(1, 1)),
+          cx(camera_matrix.at<double>(0, 2)), cy(camera_matrix.at<double>(1, 2)),
+          new_fy(new_camera_matrix.at<double>(1, 1)), new_cy(new_camera_matrix.at<double>(1, 2)),
+          normalized_x(static_cast<size_t>(arg_map1.cols))
+    {
+        const double new_fx = new_camera_matrix.at<double>(0, 0);
+        const double new_cx = new_camera_matrix.at<double>(0, 2);
+        for (int u = 0; u < map1.cols; ++u) {
+            normalized_x[static_cast<size_t>(u)] = (u - new_cx) / new_fx;
+        }
+    }
+
+    void operator()(const cv::Range& rows) const override
+    {
+        const int cols = map1.cols;
+        std::vector<double> xd(static_cast<size_t>(cols));
+        std::vector<double> yd(static_cast<size_t>(cols));
+        for (int v = rows.start; v < rows.end; ++v) {
+            DistortionEvaluator<M>::distort_row(coeffs, normalized_x.data(), (v - new_cy) / new_fy,
+                                                xd.data(), yd.data(), cols);
+            if (map1.type() == CV_16SC2) {
+                short* fixed_xy = map1.ptr<short>(v);
+                ushort* fraction = map2.ptr<ushort>(v);
+                for (int u = 0; u < cols; ++u) {
+                    /// the same encoding as initUndistortRectifyMap with CV_16SC2
+                    const int iu = cv::saturate_cast<int>((fx * xd[u] + cx) * cv::INTER_TAB_SIZE);
+                    const int iv = cv::saturate_cast<int>((fy * yd[u] + cy) * cv::INTER_TAB_SIZE);
+                    fixed_xy[2 * u] = cv::saturate_cast<short>(iu >> cv::INTER_BITS);
+                    fixed_xy[2 * u + 1] = cv::saturate_cast<short>(iv >> cv::INTER_BITS);
+                    fraction[u] = static_cast<ushort>((iv & (cv::INTER_TAB_SIZE - 1)) * cv::INTER_TAB_SIZE
+                                                      + (iu & (cv::INTER_TAB_SIZE - 1)));
+                }
+            } else {
+                float* map_x = map1.ptr<float>(v);
+                float* map_y = map2.ptr<float>(v);
+                for (int u = 0; u < cols; ++u) {
+                    map_x[u] = static_cast<float>(fx * xd[u] + cx);
+                    map_y[u] = static_cast<float>(fy * yd[u] + cy);
+                }
+            }
+        }
+    }
+
+private:
+    const DistortionCoeffs& coeffs;
+    cv::Mat& map1;
+    cv::Mat& map2;
+    double fx;
+    double fy;
+    double cx;
+    double cy;
+    double new_fy;
+    double new_cy;
+    std::vector<double> normalized_x;
+};
+
+/**
+ * @brief: Fills undistortion maps with the evaluator of model M
+ */
+template <DistortionModel M>
+static void fill_undistort_maps(const DistortionCoeffs& coeffs, const cv::Mat& camera_matrix,
+                                const cv::Mat& new_camera_matrix, cv::Mat& map1, cv::Mat& map2)
+{
+    cv::parallel_for_(cv::Range(0, map1.rows),
+                      UndistortMapBody<M>(coeffs, camera_matrix, new_camera_matrix, map1, map2));
+}
+
+/**
+ * @brief: Projects normalized points with the evaluator of model M
+ */
+template <DistortionModel M>
+static void distort_points(const DistortionCoeffs& coeffs, const cv::Mat& camera_matrix,
+                           const std::vector<cv::Point2d>& normalized,
+                           std::vector<cv::Point2f>& image_points)
+{
+    const double fx = camera_matrix.at<double>(0, 0);
+    const double fy = camera_matrix.at<double>(1, 1);
+    const double cx = camera_matrix.at<double>(0, 2);
+    const double cy = camera_matrix.at<double>(1, 2);
+    image_points.resize(normalized.size());
+    for (size_t i = 0; i < normalized.size(); ++i) {
+        double xd = 0.0;
+        double yd = 0.0;
+        DistortionEvaluator<M>::distort(coeffs, normalized[i].x, normalized[i].y, xd, yd);
+        image_points[i] = cv::Point2f(static_cast<float>(fx * xd + cx), static_cast<float>(fy * yd + cy));
+    }
+}
+
+/**
+ * @brief: Undistorts image points with the evaluator of model M
+ */
+template <DistortionModel M>
+static void undistort_points(const DistortionCoeffs& coeffs, const std::vector<cv::Point2f>& image_points,
+                             std::vector<cv::Point2f>& undistorted, const cv::Mat& camera_matrix,
+                             const cv::Mat& new_camera_matrix)
+{
+    const double fx = camera_matrix.at<double>(0, 0);
+    const double fy = camera_matrix.at<double>(1, 1);
+    const double cx = camera_matrix.at<double>(0, 2);
+    const double cy = camera_matrix.at<double>(1, 2);
+    const double new_fx = new_camera_matrix.at<double>(0, 0);
+    const double new_fy = new_camera_matrix.at<double>(1, 1);
+    const double new_cx = new_camera_matrix.at<double>(0, 2);
+    const double new_cy = new_camera_matrix.at<double>(1, 2);
+    std::vector<cv::Point2f> result(image_points.size());
+    for (size_t i = 0; i < image_points.size(); ++i) {
+        double x = 0.0;
+        double y = 0.0;
+        DistortionEvaluator<M>::undistort(coeffs, (image_points[i].x - cx) / fx,
+                                          (image_points[i].y - cy) / fy, x, y, undistort_iterations);
+        result[i] = cv::Point2f(static_cast<float>(new_fx * x + new_cx),
+                                static_cast<float>(new_fy * y + new_cy));
+    }
+    undistorted.swap(result);
+}
+
+/**
+ * @brief: Returns openCV calibrateCamera flags which estimate coefficients of a model
+ * @param model a distortion model
+ * @return: calibration flags
+ */
+int camera_ns::get_distortion_model_flags(DistortionModel model)
+{
+    switch (model) {
+        case DistortionModel::radial2:
+            return cv::CALIB_ZERO_TANGENT_DIST | cv::CALIB_FIX_K3;
+        case DistortionModel::radial_tangential:
+            return cv::CALIB_FIX_K3;
+        case DistortionModel::radial3_tangential:
+            return 0;
+        case DistortionModel::rational:
+            return cv::CALIB_RATIONAL_MODEL;
+        default:
+            return cv::CALIB_RATIONAL_MODEL | cv::CALIB_THIN_PRISM_MODEL;
+    }
+}
+
+/**
+ * @brief: Returns a number of coefficients stored for a model (in openCV layout)
+ * @param model a distortion model
+ * @return: coefficients count
+ */
+int camera_ns::get_distortion_coeffs_count(DistortionModel model)
+{
+    switch (model) {
+        case DistortionModel::radial2:
+        case DistortionModel::radial_tangential:
+        case DistortionModel::radial3_tangential:
+            return 5;
+        case DistortionModel::rational:
+            return 8;
+        default:
+            return 12;
+    }
+}
+
+/**
+ * @brief: Reads distortion coefficients, missing ones are 0
+ * @param dist_coeffs coefficients in openCV layout (4, 5, 8, 12 or 14 values)
+ * @param coeffs read coefficients
+ * @return: false for other layouts and for non-zero tilt coefficients
+ */
+bool camera_ns::get_distortion_coeffs(const cv::Mat &dist_coeffs, DistortionCoeffs &coeffs)
+{
+    const size_t count = dist_coeffs.total();
+    if ((count != 0 and count != 4 and count != 5 and count != 8 and count != 12 and count != 14)
+            or (count != 0 and dist_coeffs.channels() != 1)) {
+        return false;
+    }
+    cv::Mat values;
+    if (count != 0) {
+        dist_coeffs.reshape(1, 1).convertTo(values, CV_64F);
+    }
+    double all[14] = {};
+    for (size_t i = 0; i < count; ++i) {
+        all[i] = values.at<double>(0, static_cast<int>(i));
+    }
+    if (all[12] != 0.0 or all[13] != 0.0) {
+        return false;
+    }
+    coeffs = {all[0], all[1], all[2], all[3], all[4], all[5], all[6], all[7],
+              all[8], all[9], all[10], all[11]};
+    return true;
+}
+
+/**
+ * @brief: Finds the cheapest model evaluating the coefficients exactly, trailing zero
+ * coefficients (fixed by calibration flags) are not evaluated
+ * @param dist_coeffs coefficients in openCV layout
+ * @param model the inferred model
+ * @return: false when the coefficients have no specialized model (e.g. tilted sensor)
+ */
+bool camera_ns::infer_distortion_model(const cv::Mat &dist_coeffs, DistortionModel &model)
+{
+    DistortionCoeffs c;
+    if (get_distortion_coeffs(dist_coeffs, c) == false) {
+        return false;
+    }
+    if (c.s1 != 0.0 or c.s2 != 0.0 or c.s3 != 0.0 or c.s4 != 0.0) {
+        model = DistortionModel::thin_prism;
+    } else if (c.k4 != 0.0 or c.k5 != 0.0 or c.k6 != 0.0) {
+        model = DistortionModel::rational;
+    } else if (c.k3 != 0.0) {
+        model = DistortionModel::radial3_tangential;
+    } else if (c.p1 != 0.0 or c.p2 != 0.0) {
+        model = DistortionModel::radial_tangential;
+    } else {
+        model = DistortionModel::radial2;
+    }
+    return true;
+}
+
+/**
+ * @brief: Builds undistortion maps like initUndistortRectifyMap without rectification,
+ * rows are generated in parallel by the evaluator of the inferred model
+ * @param camera_matrix camera matrix valid for arg_size
+ * @param dist_coeffs dist coefficients
+ * @param new_camera_matrix camera matrix of the compensated image
+ * @param arg_size the capture resolution
+ * @param map_type CV_16SC2 (fixed-point map1 + CV_16UC1 map2) or CV_32FC1
+ * @param map1 the first map
+ * @param map2 the second map
+ */
+void camera_ns::build_undistort_maps(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                     const cv::Mat &new_camera_matrix, cv::Size arg_size, int map_type,
+                                     cv::Mat &map1, cv::Mat &map2)
+{
+    DistortionCoeffs coeffs;
+    DistortionModel model;
+    if ((map_type != CV_16SC2 and map_type != CV_32FC1) or camera_matrix.type() != CV_64F
+            or new_camera_matrix.type() != CV_64F or get_distortion_coeffs(dist_coeffs, coeffs) == false
+            or infer_distortion_model(dist_coeffs, model) == false) {
+        cv::initUndistortRectifyMap(camera_matrix, dist_coeffs, cv::Mat(), new_camera_matrix,
+                                    arg_size, map_type, map1, map2);
+        return;
+    }
+    map1.create(arg_size, map_type);
+    map2.create(arg_size, map_type == CV_16SC2 ? CV_16UC1 : CV_32FC1);
+    switch (model) {
+        case DistortionModel::radial2:
+            fill_undistort_maps<DistortionModel::radial2>(coeffs, camera_matrix, new_camera_matrix, map1, map2);
+            break;
+        case DistortionModel::radial_tangential:
+            fill_undistort_maps<DistortionModel::radial_tangential>(coeffs, camera_matrix, new_camera_matrix,
+                                                                    map1, map2);
+            break;
+        case DistortionModel::radial3_tangential:
+            fill_undistort_maps<DistortionModel::radial3_tangential>(coeffs, camera_matrix, new_camera_matrix,
+                                                                     map1, map2);
+            break;
+        case DistortionModel::rational:
+            fill_undistort_maps<DistortionModel::rational>(coeffs, camera_matrix, new_camera_matrix, map1, map2);
+            break;
+        default:
+            fill_undistort_maps<DistortionModel::thin_prism>(coeffs, camera_matrix, new_camera_matrix,
+                                                             map1, map2);
+            break;
+    }
+}
+
+/**
+ * @brief: Projects points given in normalized camera coordinates to the distorted image,
+ * like projectPoints with zero rotation and translation
+ * @param camera_matrix camera matrix
+ * @param dist_coeffs dist coefficients
+ * @param normalized points in normalized camera coordinates (z = 1)
+ * @param image_points projected points [px]
+ */
+void camera_ns::distort_normalized_points(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                          const std::vector<cv::Point2d> &normalized,
+                                          std::vector<cv::Point2f> &image_points)
+{
+    DistortionCoeffs coeffs;
+    DistortionModel model;
+    if (camera_matrix.type() != CV_64F or get_distortion_coeffs(dist_coeffs, coeffs) == false
+            or infer_distortion_model(dist_coeffs, model) == false) {
+        std::vector<cv::Point3d> object_points(normalized.size());
+        for (size_t i = 0; i < normalized.size(); ++i) {
+            object_points[i] = cv::Point3d(normalized[i].x, normalized[i].y, 1.0);
+        }
+        cv::projectPoints(object_points, cv::Mat::zeros(3, 1, CV_64F), cv::Mat::zeros(3, 1, CV_64F),
+                          camera_matrix, dist_coeffs, image_points);
+        return;
+    }
+    switch (model) {
+        case DistortionModel::radial2:
+            distort_points<DistortionModel::radial2>(coeffs, camera_matrix, normalized, image_points);
+            break;
+        case DistortionModel::radial_tangential:
+            distort_points<DistortionModel::radial_tangential>(coeffs, camera_matrix, normalized, image_points);
+            break;
+        case DistortionModel::radial3_tangential:
+            distort_points<DistortionModel::radial3_tangential>(coeffs, camera_matrix, normalized, image_points);
+            break;
+        case DistortionModel::rational:
+            distort_points<DistortionModel::rational>(coeffs, camera_matrix, normalized, image_points);
+            break;
+        default:
+            distort_points<DistortionModel::thin_prism>(coeffs, camera_matrix, normalized, image_points);
+            break;
+    }
+}
+
+/**
+ * @brief: Undistorts image points like undistortPoints with new camera matrix as P
+ * @param image_points distorted points [px]
+ * @param undistorted undistorted points in the compensated image [px], may alias image_points
+ * @param camera_matrix camera matrix
+ * @param dist_coeffs dist coefficients
+ * @param new_camera_matrix camera matrix of the compensated image
+ */
+void camera_ns::undistort_image_points(const std::vector<cv::Point2f> &image_points,
+                                       std::vector<cv::Point2f> &undistorted,
+                                       const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs,
+                                       const cv::Mat &new_camera_matrix)
+{
+    DistortionCoeffs coeffs;
+    DistortionModel model;
+    if (camera_matrix.type() != CV_64F or new_camera_matrix.type() != CV_64F
+            or get_distortion_coeffs(dist_coeffs, coeffs) == false
+            or infer_distortion_model(dist_coeffs, model) == false) {
+        std::vector<cv::Point2f> result;
+        if (image_points.empty() == false) {
+            cv::undistortPoints(image_points, result, camera_matrix, dist_coeffs, cv::noArray(),
+                                new_camera_matrix);
+        }
+        undistorted.swap(result);
+        return;
+    }
+    switch (model) {
+        case DistortionModel::radial2:
+            undistort_points<DistortionModel::radial2>(coeffs, image_points, undistorted,
+                                                       camera_matrix, new_camera_matrix);
+            break;
+        case DistortionModel::radial_tangential:
+            undistort_points<DistortionModel::radial_tangential>(coeffs, image_points, undistorted,
+                                                                 camera_matrix, new_camera_matrix);
+            break;
+        case DistortionModel::radial3_tangential:
+            undistort_points<DistortionModel::radial3_tangential>(coeffs, image_points, undistorted,
+                                                                  camera_matrix, new_camera_matrix);
+            break;
+        case DistortionModel::rational:
+            undistort_points<DistortionModel::rational>(coeffs, image_points, undistorted,
+                                                        camera_matrix, new_camera_matrix);
+            break;
+        default:
+            undistort_points<DistortionModel::thin_prism>(coeffs, image_points, undistorted,
+                                                          camera_matrix, new_camera_matrix);
+            break;
+    }
+}
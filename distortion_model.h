@@ -0,0 +1,149 @@
+/**
+  @file distortion_model.h
+  @brief Distortion-model specialized evaluators used for map generation and point undistortion
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef DISTORTION_MODEL_H
+#define DISTORTION_MODEL_H
+
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace camera_ns {
+    /**
+     * @brief The DistortionModel enum to chose the distortion coefficients
+     * estimated by calibration, from the cheapest to the most general one:
+     * radial2 - k1, k2
+     * radial_tangential - k1, k2, p1, p2
+     * radial3_tangential - k1, k2, p1, p2, k3 (openCV default, 5 coefficients)
+     * rational - k1..k6, p1, p2
+     * thin_prism - k1..k6, p1, p2, s1..s4
+     */
+    enum class DistortionModel {
+        radial2,
+        radial_tangential,
+        radial3_tangential,
+        rational,
+        thin_prism
+    };
+
+    /**
+     * @brief The DistortionCoeffs struct keeps coefficients in openCV order
+     */
+    struct DistortionCoeffs {
+        double k1, k2, p1, p2, k3, k4, k5, k6, s1, s2, s3, s4;
+    };
+
+    /**
+     * @brief The DistortionEvaluator struct evaluates a distortion model specialized
+     * at compile time, terms of coefficients the model does not have are not emitted.
+     */
+    template <DistortionModel M>
+    struct DistortionEvaluator
+    {
+        static const bool has_tangential = M != DistortionModel::radial2;
+        static const bool has_rational = M == DistortionModel::rational
+                or M == DistortionModel::thin_prism;
+        static const bool has_k3 = M == DistortionModel::radial3_tangential or has_rational;
+        static const bool has_thin_prism = M == DistortionModel::thin_prism;
+
+        /**
+         * @brief: Distorts a point in normalized camera coordinates
+         */
+        static void distort(const DistortionCoeffs& c, double x, double y, double& xd, double& yd)
+        {
+            const double x2 = x * x;
+            const double y2 = y * y;
+            const double r2 = x2 + y2;
+            const double r4 = r2 * r2;
+            double radial = 1.0 + c.k1 * r2 + c.k2 * r4;
+            if (has_k3) {
+                radial += c.k3 * r4 * r2;
+            }
+            if (has_rational) {
+                radial /= 1.0 + c.k4 * r2 + c.k5 * r4 + c.k6 * r4 * r2;
+            }
+            xd = x * radial;
+            yd = y * radial;
+            if (has_tangential) {
+                const double xy2 = 2.0 * x * y;
+                xd += c.p1 * xy2 + c.p2 * (r2 + 2.0 * x2);
+                yd += c.p1 * (r2 + 2.0 * y2) + c.p2 * xy2;
+            }
+            if (has_thin_prism) {
+                xd += c.s1 * r2 + c.s2 * r4;
+                yd += c.s3 * r2 + c.s4 * r4;
+            }
+        }
+
+        /**
+         * @brief: Distorts a row of points sharing the normalized y coordinate
+         */
+        static void distort_row(const DistortionCoeffs& c, const double* x, double y,
+                                double* xd, double* yd, int count)
+        {
+            for (int i = 0; i < count; ++i) {
+                distort(c, x[i], y, xd[i], yd[i]);
+            }
+        }
+
+        /**
+         * @brief: Undistorts a point in normalized camera coordinates with
+         * fixed-point iterations, as openCV undistortPoints does
+         */
+        static void undistort(const DistortionCoeffs& c, double xd, double yd, double& x, double& y,
+                              int iterations)
+        {
+            x = xd;
+            y = yd;
+            for (int i = 0; i < iterations; ++i) {
+                const double x2 = x * x;
+                const double y2 = y * y;
+                const double r2 = x2 + y2;
+                const double r4 = r2 * r2;
+                double radial = 1.0 + c.k1 * r2 + c.k2 * r4;
+                if (has_k3) {
+                    radial += c.k3 * r4 * r2;
+                }
+                double inverse_radial = 1.0 / radial;
+                if (has_rational) {
+                    inverse_radial *= 1.0 + c.k4 * r2 + c.k5 * r4 + c.k6 * r4 * r2;
+                }
+                double delta_x = 0.0;
+                double delta_y = 0.0;
+                if (has_tangential) {
+                    const double xy2 = 2.0 * x * y;
+                    delta_x += c.p1 * xy2 + c.p2 * (r2 + 2.0 * x2);
+                    delta_y += c.p1 * (r2 + 2.0 * y2) + c.p2 * xy2;
+                }
+                if (has_thin_prism) {
+                    delta_x += c.s1 * r2 + c.s2 * r4;
+                    delta_y += c.s3 * r2 + c.s4 * r4;
+                }
+                x = (xd - delta_x) * inverse_radial;
+                y = (yd - delta_y) * inverse_radial;
+            }
+        }
+    };
+
+    int get_distortion_model_flags(DistortionModel model);
+    int get_distortion_coeffs_count(DistortionModel model);
+    bool get_distortion_coeffs(const cv::Mat& dist_coeffs, DistortionCoeffs& coeffs);
+    bool infer_distortion_model(const cv::Mat& dist_coeffs, DistortionModel& model);
+
+    void build_undistort_maps(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                              const cv::Mat& new_camera_matrix, cv::Size arg_size, int map_type,
+                              cv::Mat& map1, cv::Mat& map2);
+    void distort_normalized_points(const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                                   const std::vector<cv::Point2d>& normalized,
+                                   std::vector<cv::Point2f>& image_points);
+    void undistort_image_points(const std::vector<cv::Point2f>& image_points,
+                                std::vector<cv::Point2f>& undistorted,
+                                const cv::Mat& camera_matrix, const cv::Mat& dist_coeffs,
+                                const cv::Mat& new_camera_matrix);
+}
+
+#endif // DISTORTION_MODEL_H
@@ -0,0 +1,126 @@
+/**
+  @file frame_source.cpp
+  @brief A definitions of frame sources delivering frame rows incrementally
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <algorithm>
+#include "frame_source.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: A default destructor
+ */
+IncrementalFrameSource::~IncrementalFrameSource()
+{
+}
+
+/**
+ * @brief: A constructor
+ * @param arg_size a frame size
+ * @param arg_type a frame type (e.g. CV_8UC3 for BGR24)
+ * @param arg_rows_per_read a number of rows read at once by read_rows()
+ */
+RawFrameSource::RawFrameSource(cv::Size arg_size, int arg_type, int arg_rows_per_read)
+    : file(nullptr), frame_size(arg_size), frame_type(arg_type),
+      rows_per_read(std::max(arg_rows_per_read, 1)), bytes_read(0)
+{
+}
+
+/**
+ * @brief: A destructor, closes the file
+ */
+RawFrameSource::~RawFrameSource()
+{
+    close();
+}
+
+/**
+ * @brief: Opens a file, FIFO or device to read frames from
+ * @param file_name a file name, "-" reads the standard input
+ * @return: false when the file cannot be opened or the frame size is empty
+ */
+bool RawFrameSource::open(const std::string &file_name)
+{
+    close();
+    if (frame_size.area() <= 0) {
+        return false;
+    }
+    if (file_name == "-") {
+        file = stdin;
+    } else {
+        file = std::fopen(file_name.c_str(), "rb");
+    }
+    return file != nullptr;
+}
+
+/**
+ * @brief: Closes the file
+ */
+void RawFrameSource::close()
+{
+    if (file != nullptr and file != stdin) {
+        std::fclose(file);
+    }
+    file = nullptr;
+}
+
+/**
+ * @brief: Check if the file is open
+ * @return: open flag
+ */
+bool RawFrameSource::get_open() const
+{
+    return file != nullptr;
+}
+
+/**
+ * @brief: Starts the next frame
+ * @param frame a frame allocated with the frame size and type
+ * @return: false when the file is not open or has ended
+ */
+bool RawFrameSource::begin_frame(cv::Mat &frame)
+{
+    if (file == nullptr or std::feof(file) or std::ferror(file)) {
+        return false;
+    }
+    /// the first byte is awaited here, so the end of stream is not mistaken for a truncated frame
+    int first = std::fgetc(file);
+    if (first == EOF) {
+        return false;
+    }
+    std::ungetc(first, file);
+    frame.create(frame_size, frame_type);
+    bytes_read = 0;
+    return true;
+}
+
+/**
+ * @brief: Reads next rows of the frame
+ * @param frame the frame passed to begin_frame()
+ * @return: number of complete rows, -1 when the file ended before the frame was complete
+ */
+int RawFrameSource::read_rows(cv::Mat &frame)
+{
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    const size_t frame_bytes = row_bytes * frame.rows;
+    if (file == nullptr or frame.isContinuous() == false) {
+        return -1;
+    }
+    if (bytes_read < frame_bytes) {
+        /// complete the row read partially last time and read rows_per_read rows more
+        const size_t target = std::min(frame_bytes, (bytes_read / row_bytes + rows_per_read) * row_bytes);
+        while (bytes_read < target) {
+            size_t count = std::fread(frame.data + bytes_read, 1, target - bytes_read, file);
+            if (count == 0) {
+                return -1;
+            }
+            bytes_read += count;
+        }
+    }
+    return static_cast<int>(bytes_read / row_bytes);
+}
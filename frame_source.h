@@ -0,0 +1,73 @@
+/**
+  @file frame_source.h
+  @brief A declarations of frame sources delivering frame rows incrementally
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <cstdio>
+#include <string>
+#include <opencv2/core.hpp>
+
+namespace camera_ns {
+    /**
+     * @brief The IncrementalFrameSource class is an interface of frame sources
+     * which deliver rows of a frame from top to bottom while it is read out
+     * (raw sensor or pipe readers, line-based drivers), so processing of the
+     * top of the frame can start before the bottom has arrived
+     */
+    class IncrementalFrameSource
+    {
+    public:
+        virtual ~IncrementalFrameSource();
+
+        /**
+         * @brief: Starts the next frame
+         * @param frame a frame allocated by the source with the frame size and type,
+         * its rows are filled by read_rows()
+         * @return: false when there are no more frames
+         */
+        virtual bool begin_frame(cv::Mat& frame) = 0;
+
+        /**
+         * @brief: Waits for more rows of the frame started by begin_frame()
+         * @param frame the frame passed to begin_frame()
+         * @return: number of complete rows from the top of the frame,
+         * -1 when the source ended or failed before the frame was complete
+         */
+        virtual int read_rows(cv::Mat& frame) = 0;
+    };
+
+    /**
+     * @brief The RawFrameSource class reads frames of a fixed size and type stored
+     * row by row without padding, from a file, a FIFO or a pipe (e.g. raw video
+     * written by a capture driver or "ffmpeg -f rawvideo")
+     */
+    class RawFrameSource : public IncrementalFrameSource
+    {
+    public:
+        RawFrameSource(cv::Size arg_size, int arg_type, int arg_rows_per_read = 16);
+        ~RawFrameSource() override;
+        RawFrameSource(const RawFrameSource&) = delete;
+        RawFrameSource& operator=(const RawFrameSource&) = delete;
+
+        bool open(const std::string& file_name);
+        void close();
+        bool get_open() const;
+        bool begin_frame(cv::Mat& frame) override;
+        int read_rows(cv::Mat& frame) override;
+
+    private:
+        std::FILE* file;
+        cv::Size frame_size;
+        int frame_type;
+        int rows_per_read;
+        size_t bytes_read;
+    };
+}
+
+#endif // FRAME_SOURCE_H
@@ -6,10 +6,14 @@
   @version 1.0
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <thread>
 #include <gtest/gtest.h>
 #include "camera.h"
+#include "display.h"
 
 //#define RUN_TESTS
 //#define CAM_CALIBRATE
@@ -25,28 +29,43 @@ int main(int argc, char** argv)
     cam.set_number_of_images_to_calibrate(15);
     try {
         cam.calibrate();
-    } catch (camera_ns::ExceptionMessage ex) {
+    } catch (const camera_ns::ExceptionMessage& ex) {
         std::cout << ex.msg << std::endl;
     }
 #endif
     if(cam.get_calibrated() == false) {
         try {
             cam.load_camera_calibration_data();
-        } catch (camera_ns::ExceptionMessage ex) {
+        } catch (const camera_ns::ExceptionMessage& ex) {
             std::cout << ex.msg << std::endl;
         }
     }
-    while (true) {
-        try {
-            cam.read();
-            cam.show_frame_raw();
-            cam.compensate_distortions(camera_ns::CorrectionType::undistort);
-            cam.show_frame_compensated();
-        } catch (camera_ns::ExceptionMessage ex) {
-            std::cout << ex.msg << std::endl;
+    camera_ns::DisplayService display;
+    display.set_max_refresh_rate(30.0);
+#ifndef __APPLE__
+    display.start();
+#endif
+    std::chrono::milliseconds retry_delay(10);
+    while (display.get_last_key() != 27) {
+#ifdef __APPLE__
+        /// HighGUI windows can be used only from the main thread on macOS
+        display.refresh();
+#endif
+        if (cam.try_read() != camera_ns::ExceptionID::ok) {
+            /// back off while the camera is missing or failing
+            std::this_thread::sleep_for(retry_delay);
+            retry_delay = std::min(2 * retry_delay, std::chrono::milliseconds(1000));
+            continue;
         }
-        cv::waitKey(10);
+        retry_delay = std::chrono::milliseconds(10);
+        cam.try_compensate_distortions(camera_ns::CorrectionType::undistort);
+        display.post(cam.get_reference_to_frame_raw(),
+                     cam.get_reference_to_frame_calibrated());
     }
+    display.stop();
+    std::cout << "Frame reading failures: "
+              << cam.get_error_count(camera_ns::ExceptionID::camera_reading_failure) << std::endl;
+    return 0;
 #else
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
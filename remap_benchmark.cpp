@@ -0,0 +1,144 @@
+/**
+  @file remap_benchmark.cpp
+  @brief A remap benchmark: cv::remap vs the specialized kernels with dense
+  fixed-point undistortion maps, for every frame type with a kernel
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "calibration_data.h"
+#include "remap_kernels.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+ * @brief The BenchmarkSettings struct to keep command line settings
+ */
+struct BenchmarkSettings {
+    cv::Size image_size = cv::Size(1920, 1080);
+    int repeats = 50;
+};
+
+/**
+ * @brief The FrameType struct to describe the benchmarked frame type
+ */
+struct FrameType {
+    std::string name;
+    int type;
+};
+
+/**
+ * @brief: Parses WxH string
+ */
+static cv::Size parse_size(const std::string& text)
+{
+    int width = 0;
+    int height = 0;
+    char separator = 0;
+    std::istringstream stream(text);
+    stream >> width >> separator >> height;
+    return cv::Size(width, height);
+}
+
+/**
+ * @brief: Reads command line settings
+ * @return: false when arguments are wrong
+ */
+static bool parse_settings(int argc, char** argv, BenchmarkSettings& settings)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--resolution") {
+            settings.image_size = parse_size(value);
+        } else if (key == "--repeats") {
+            settings.repeats = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 and settings.image_size.area() > 0 and settings.repeats > 0;
+}
+
+/**
+ * @brief: Builds dense undistortion maps of a typical wide angle lens
+ */
+static void make_maps(cv::Size image_size, cv::Mat& map1, cv::Mat& map2)
+{
+    cv::Mat camera_matrix = cv::Mat::eye(3, 3, CV_64F);
+    camera_matrix.at<double>(0, 0) = 0.9 * image_size.width;
+    camera_matrix.at<double>(1, 1) = 0.9 * image_size.width;
+    camera_matrix.at<double>(0, 2) = 0.5 * image_size.width - 0.5;
+    camera_matrix.at<double>(1, 2) = 0.5 * image_size.height - 0.5;
+    cv::Mat dist_coeffs = (cv::Mat_<double>(5, 1) << -0.28, 0.09, 0.0008, -0.0005, -0.01);
+    camera_ns::RemapMaps maps;
+    camera_ns::build_dense_remap_maps(camera_matrix, dist_coeffs, image_size, maps);
+    map1 = maps.map1;
+    map2 = maps.map2;
+}
+
+/**
+ * @brief: Returns the average time of single remap [ms]
+ */
+template <typename Remap>
+static double time_remap(int repeats, Remap remap)
+{
+    /// the first call allocates the destination frame and warms up the thread pool
+    remap();
+    bench_clock::time_point start = bench_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        remap();
+    }
+    bench_clock::time_point stop = bench_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count() / repeats;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    if (parse_settings(argc, argv, settings) == false) {
+        std::cout << "Usage: " << argv[0] << " [--resolution WxH] [--repeats n]" << std::endl;
+        return 1;
+    }
+    cv::Mat map1, map2;
+    make_maps(settings.image_size, map1, map2);
+    const camera_ns::FixedPointMapSampler sampler(map1, map2);
+    const cv::Range all_rows(0, settings.image_size.height);
+
+    const FrameType types[] = {{"8UC1", CV_8UC1}, {"8UC3", CV_8UC3}, {"8UC4", CV_8UC4},
+                               {"16UC1", CV_16UC1}, {"16UC3", CV_16UC3}, {"16UC4", CV_16UC4},
+                               {"32FC1", CV_32FC1}, {"32FC3", CV_32FC3}, {"32FC4", CV_32FC4}};
+    std::cout << "resolution " << settings.image_size.width << "x" << settings.image_size.height
+              << ", repeats " << settings.repeats << ", threads " << cv::getNumThreads() << std::endl;
+    std::cout << "type,interpolation,opencv_ms,kernel_ms,kernel_used" << std::endl;
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        cv::Mat src(settings.image_size, types[t].type);
+        cv::randu(src, 0, 255);
+        cv::Mat dst_opencv;
+        cv::Mat dst_kernel(settings.image_size, types[t].type);
+        for (int linear = 1; linear >= 0; --linear) {
+            const camera_ns::RemapInterpolation interpolation = linear ? camera_ns::RemapInterpolation::linear
+                                                                       : camera_ns::RemapInterpolation::nearest;
+            double opencv_ms = time_remap(settings.repeats, [&]() {
+                cv::remap(src, dst_opencv, map1, map2, linear ? cv::INTER_LINEAR : cv::INTER_NEAREST,
+                          cv::BORDER_CONSTANT, cv::Scalar());
+            });
+            double kernel_ms = time_remap(settings.repeats, [&]() {
+                camera_ns::remap_rows(src, dst_kernel, sampler, interpolation, all_rows);
+            });
+            std::cout << types[t].name << "," << (linear ? "linear" : "nearest") << ","
+                      << opencv_ms << "," << kernel_ms << ","
+                      << (camera_ns::is_dense_remap_kernel_preferred(types[t].type) ? "yes" : "no")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
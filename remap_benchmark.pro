@@ -0,0 +1,26 @@
+TEMPLATE = app
+TARGET = remap_benchmark
+CONFIG += console c++11
+CONFIG -= app_bundle
+CONFIG -= qt
+
+SOURCES += \
+        remap_benchmark.cpp \
+    calibration_data.cpp \
+    coarse_remap.cpp \
+    distortion_model.cpp \
+    remap_kernels.cpp
+
+INCLUDEPATH += /usr/local/include/opencv
+
+LIBS += -L/usr/local/lib/
+LIBS += -lopencv_core
+LIBS += -lopencv_imgproc
+LIBS += -lopencv_calib3d
+LIBS += -lpthread
+
+HEADERS += \
+    calibration_data.h \
+    coarse_remap.h \
+    distortion_model.h \
+    remap_kernels.h
@@ -0,0 +1,204 @@
+/**
+  @file remap_kernels.cpp
+  @brief A definitions of remap kernels map samplers and type dispatch
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <opencv2/imgproc.hpp>
+#include "remap_kernels.h"
+
+
+using namespace camera_ns;
+
+/**
+ * @brief: Returns the source coordinates buffer of the calling thread, it is
+ * allocated once per thread and reused by every band remapped on the thread
+ * @param count a number of floats needed
+ * @return: buffer of at least count floats
+ */
+float* camera_ns::get_remap_row_buffer(size_t count)
+{
+    static thread_local std::vector<float> buffer;
+    if (buffer.size() < count) {
+        buffer.resize(count);
+    }
+    return buffer.data();
+}
+
+/**
+ * @brief: A fixed-point map sampler constructor
+ * @param arg_map1 CV_16SC2 map with integer source coordinates
+ * @param arg_map2 CV_16UC1 map with interpolation table indexes (can be empty)
+ */
+FixedPointMapSampler::FixedPointMapSampler(const cv::Mat &arg_map1, const cv::Mat &arg_map2)
+    : map1(arg_map1), map2(arg_map2)
+{
+}
+
+/**
+ * @brief: Returns the destination size described by the maps
+ * @return: size of the maps
+ */
+cv::Size FixedPointMapSampler::size() const
+{
+    return map1.size();
+}
+
+/**
+ * @brief: Decodes source coordinates of single destination row
+ * @param y a destination row
+ * @param src_x an output buffer for source x coordinates
+ * @param src_y an output buffer for source y coordinates
+ */
+void FixedPointMapSampler::fill_row(int y, float *src_x, float *src_y) const
+{
+    const float scale = 1.0f / cv::INTER_TAB_SIZE;
+    const short* xy = map1.ptr<short>(y);
+    const ushort* fraction = map2.empty() ? nullptr : map2.ptr<ushort>(y);
+    for (int x = 0; x < map1.cols; ++x) {
+        float fx = xy[2 * x];
+        float fy = xy[2 * x + 1];
+        if (fraction != nullptr) {
+            const int idx = fraction[x] & (cv::INTER_TAB_SIZE2 - 1);
+            fx += (idx & (cv::INTER_TAB_SIZE - 1)) * scale;
+            fy += (idx >> cv::INTER_BITS) * scale;
+        }
+        src_x[x] = fx;
+        src_y[x] = fy;
+    }
+}
+
+/**
+ * @brief: A float map sampler constructor
+ * @param arg_map1 CV_32FC2 map or CV_32FC1 map with x coordinates
+ * @param arg_map2 CV_32FC1 map with y coordinates (empty for CV_32FC2 map1)
+ */
+FloatMapSampler::FloatMapSampler(const cv::Mat &arg_map1, const cv::Mat &arg_map2)
+    : map1(arg_map1), map2(arg_map2)
+{
+}
+
+/**
+ * @brief: Returns the destination size described by the maps
+ * @return: size of the maps
+ */
+cv::Size FloatMapSampler::size() const
+{
+    return map1.size();
+}
+
+/**
+ * @brief: Reads source coordinates of single destination row
+ * @param y a destination row
+ * @param src_x an output buffer for source x coordinates
+ * @param src_y an output buffer for source y coordinates
+ */
+void FloatMapSampler::fill_row(int y, float *src_x, float *src_y) const
+{
+    if (map1.type() == CV_32FC2) {
+        const float* xy = map1.ptr<float>(y);
+        for (int x = 0; x < map1.cols; ++x) {
+            src_x[x] = xy[2 * x];
+            src_y[x] = xy[2 * x + 1];
+        }
+    } else {
+        const float* xs = map1.ptr<float>(y);
+        const float* ys = map2.ptr<float>(y);
+        for (int x = 0; x < map1.cols; ++x) {
+            src_x[x] = xs[x];
+            src_y[x] = ys[x];
+        }
+    }
+}
+
+/**
+ * @brief: Checks if there is a specialized kernel for a cv::Mat type
+ * @param type a cv::Mat type
+ * @return: true when the type has a specialized kernel
+ */
+bool camera_ns::is_remap_type_supported(int type)
+{
+    switch (type) {
+        case CV_8UC1: case CV_8UC3: case CV_8UC4:
+        case CV_16UC1: case CV_16UC3: case CV_16UC4:
+        case CV_32FC1: case CV_32FC3: case CV_32FC4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief: Checks if the specialized kernel is faster than cv::remap with dense maps.
+ * The kernels are scalar loops while cv::remap is SIMD optimized, so every type is
+ * left to cv::remap; a type is switched to the kernel only after remap_benchmark
+ * numbers show the kernel faster for it.
+ * @param type a cv::Mat type
+ * @return: true when the kernel should be used with dense maps
+ */
+bool camera_ns::is_dense_remap_kernel_preferred(int type)
+{
+    static_cast<void>(type);
+    return false;
+}
+
+/**
+ * @brief: Remaps whole frame with the kernel specialized for src type
+ * @param src a source frame
+ * @param dst a destination frame
+ * @param map1 a first map (CV_16SC2, CV_32FC2 or CV_32FC1)
+ * @param map2 a second map (CV_16UC1, CV_32FC1 or empty)
+ * @param interpolation a sampling method
+ * @return: false when src type or map types are not supported or cv::remap
+ * is faster for src type, the caller should then fall back to cv::remap
+ */
+bool camera_ns::remap_frame(const cv::Mat &src, cv::Mat &dst, const cv::Mat &map1,
+                            const cv::Mat &map2, RemapInterpolation interpolation)
+{
+    if (src.empty() || map1.empty() || is_dense_remap_kernel_preferred(src.type()) == false) {
+        return false;
+    }
+    /// dst cannot alias src, kernels read src while writing dst
+    if (dst.data == src.data) {
+        dst = cv::Mat();
+    }
+    const cv::Range all_rows(0, map1.rows);
+    if (map1.type() == CV_16SC2) {
+        dst.create(map1.size(), src.type());
+        return remap_rows(src, dst, FixedPointMapSampler(map1, map2), interpolation, all_rows);
+    }
+    if (map1.type() == CV_32FC2 || (map1.type() == CV_32FC1 && map2.type() == CV_32FC1)) {
+        dst.create(map1.size(), src.type());
+        return remap_rows(src, dst, FloatMapSampler(map1, map2), interpolation, all_rows);
+    }
+    return false;
+}
+
+/**
+ * @brief: Remaps a band of destination rows with dense maps, using the specialized
+ * kernel where it is preferred and cv::remap on the band otherwise
+ * @param src a source frame, only the rows sampled by the band have to be valid
+ * @param dst a destination frame, already allocated with the maps size and src type
+ * @param map1 a first map (CV_16SC2)
+ * @param map2 a second map (CV_16UC1)
+ * @param interpolation a sampling method
+ * @param rows a band of destination rows to process
+ */
+void camera_ns::remap_band(const cv::Mat &src, cv::Mat &dst, const cv::Mat &map1, const cv::Mat &map2,
+                           RemapInterpolation interpolation, const cv::Range &rows)
+{
+    if (rows.empty()) {
+        return;
+    }
+    if (is_dense_remap_kernel_preferred(src.type())) {
+        remap_rows(src, dst, FixedPointMapSampler(map1, map2), interpolation, rows);
+        return;
+    }
+    /// the band of dst is a view, cv::remap writes into it without reallocation
+    cv::Mat dst_band = dst.rowRange(rows);
+    cv::remap(src, dst_band, map1.rowRange(rows), map2.empty() ? cv::Mat() : map2.rowRange(rows),
+              interpolation == RemapInterpolation::nearest ? cv::INTER_NEAREST : cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT, cv::Scalar());
+}
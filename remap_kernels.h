@@ -0,0 +1,288 @@
+/**
+  @file remap_kernels.h
+  @brief Pixel-type specialized remap kernels used on the correction path
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef REMAP_KERNELS_H
+#define REMAP_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace camera_ns {
+    /**
+     * @brief The RemapInterpolation enum to chose the sampling
+     * method of remap kernels
+     */
+    enum class RemapInterpolation {
+        nearest,
+        linear
+    };
+
+    /**
+     * @brief The FixedPointMapSampler class decodes the CV_16SC2 + CV_16UC1
+     * maps produced by initUndistortRectifyMap into source coordinates
+     */
+    class FixedPointMapSampler
+    {
+    public:
+        FixedPointMapSampler(const cv::Mat& arg_map1, const cv::Mat& arg_map2);
+        cv::Size size() const;
+        void fill_row(int y, float* src_x, float* src_y) const;
+
+    private:
+        const cv::Mat& map1;
+        const cv::Mat& map2;
+    };
+
+    /**
+     * @brief The FloatMapSampler class reads source coordinates from
+     * CV_32FC2 map or a pair of CV_32FC1 maps
+     */
+    class FloatMapSampler
+    {
+    public:
+        FloatMapSampler(const cv::Mat& arg_map1, const cv::Mat& arg_map2);
+        cv::Size size() const;
+        void fill_row(int y, float* src_x, float* src_y) const;
+
+    private:
+        const cv::Mat& map1;
+        const cv::Mat& map2;
+    };
+
+    /**
+     * @brief The RemapPixels struct holds the per-row sampling loops,
+     * specialized at compile time on a pixel depth and channel count
+     */
+    template <typename T, int CN>
+    struct RemapPixels
+    {
+        static void linear(const cv::Mat& src, T* dst_row, const float* src_x,
+                           const float* src_y, int count)
+        {
+            const int last_col = src.cols - 1;
+            const int last_row = src.rows - 1;
+            for (int i = 0; i < count; ++i) {
+                const float fx = src_x[i];
+                const float fy = src_y[i];
+                const int x0 = cvFloor(fx);
+                const int y0 = cvFloor(fy);
+                const float ax = fx - static_cast<float>(x0);
+                const float ay = fy - static_cast<float>(y0);
+                const float w00 = (1.0f - ax) * (1.0f - ay);
+                const float w01 = ax * (1.0f - ay);
+                const float w10 = (1.0f - ax) * ay;
+                const float w11 = ax * ay;
+                T* out = dst_row + i * CN;
+
+                if (x0 >= 0 && y0 >= 0 && x0 < last_col && y0 < last_row) {
+                    const T* p0 = src.ptr<T>(y0) + x0 * CN;
+                    const T* p1 = src.ptr<T>(y0 + 1) + x0 * CN;
+                    for (int c = 0; c < CN; ++c) {
+                        const float value = p0[c] * w00 + p0[c + CN] * w01
+                                + p1[c] * w10 + p1[c + CN] * w11;
+                        out[c] = cv::saturate_cast<T>(value);
+                    }
+                } else {
+                    /// border: taps outside the source image are treated as 0
+                    float acc[CN] = {};
+                    accumulate_tap(src, x0, y0, w00, acc);
+                    accumulate_tap(src, x0 + 1, y0, w01, acc);
+                    accumulate_tap(src, x0, y0 + 1, w10, acc);
+                    accumulate_tap(src, x0 + 1, y0 + 1, w11, acc);
+                    for (int c = 0; c < CN; ++c) {
+                        out[c] = cv::saturate_cast<T>(acc[c]);
+                    }
+                }
+            }
+        }
+
+        static void nearest(const cv::Mat& src, T* dst_row, const float* src_x,
+                            const float* src_y, int count)
+        {
+            for (int i = 0; i < count; ++i) {
+                const int x = cvFloor(src_x[i] + 0.5f);
+                const int y = cvFloor(src_y[i] + 0.5f);
+                T* out = dst_row + i * CN;
+                if (x >= 0 && y >= 0 && x < src.cols && y < src.rows) {
+                    const T* p = src.ptr<T>(y) + x * CN;
+                    for (int c = 0; c < CN; ++c) {
+                        out[c] = p[c];
+                    }
+                } else {
+                    for (int c = 0; c < CN; ++c) {
+                        out[c] = T();
+                    }
+                }
+            }
+        }
+
+    private:
+        static void accumulate_tap(const cv::Mat& src, int x, int y, float weight, float* acc)
+        {
+            if (x < 0 || y < 0 || x >= src.cols || y >= src.rows) {
+                return;
+            }
+            const T* p = src.ptr<T>(y) + x * CN;
+            for (int c = 0; c < CN; ++c) {
+                acc[c] += p[c] * weight;
+            }
+        }
+    };
+
+    float* get_remap_row_buffer(size_t count);
+
+    /**
+     * @brief The RemapBody class runs a specialized kernel over a band of
+     * destination rows; used with cv::parallel_for_
+     */
+    template <typename T, int CN, typename Sampler>
+    class RemapBody : public cv::ParallelLoopBody
+    {
+    public:
+        RemapBody(const cv::Mat& arg_src, cv::Mat& arg_dst, const Sampler& arg_sampler,
+                  RemapInterpolation arg_interpolation)
+            : src(arg_src), dst(arg_dst), sampler(arg_sampler),
+              interpolation(arg_interpolation)
+        {
+        }
+
+        void operator()(const cv::Range& rows) const override
+        {
+            float* src_x = get_remap_row_buffer(2 * static_cast<size_t>(dst.cols));
+            float* src_y = src_x + dst.cols;
+            for (int y = rows.start; y < rows.end; ++y) {
+                sampler.fill_row(y, src_x, src_y);
+                T* dst_row = dst.ptr<T>(y);
+                if (interpolation == RemapInterpolation::nearest) {
+                    RemapPixels<T, CN>::nearest(src, dst_row, src_x, src_y, dst.cols);
+                } else {
+                    RemapPixels<T, CN>::linear(src, dst_row, src_x, src_y, dst.cols);
+                }
+            }
+        }
+
+    private:
+        const cv::Mat& src;
+        cv::Mat& dst;
+        const Sampler& sampler;
+        RemapInterpolation interpolation;
+    };
+
+    /**
+     * @brief: Runs the kernel specialized for the type of src over a band of rows
+     * @param src a source frame
+     * @param dst a destination frame, already allocated with the sampler size
+     * @param sampler a source coordinates provider
+     * @param interpolation a sampling method
+     * @param rows a band of destination rows to process
+     * @return: false when there is no specialized kernel for the src type
+     */
+    template <typename Sampler>
+    bool remap_rows(const cv::Mat& src, cv::Mat& dst, const Sampler& sampler,
+                    RemapInterpolation interpolation, const cv::Range& rows)
+    {
+        switch (src.type()) {
+            case CV_8UC1:
+                cv::parallel_for_(rows, RemapBody<uint8_t, 1, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_8UC3:
+                cv::parallel_for_(rows, RemapBody<uint8_t, 3, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_8UC4:
+                cv::parallel_for_(rows, RemapBody<uint8_t, 4, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_16UC1:
+                cv::parallel_for_(rows, RemapBody<uint16_t, 1, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_16UC3:
+                cv::parallel_for_(rows, RemapBody<uint16_t, 3, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_16UC4:
+                cv::parallel_for_(rows, RemapBody<uint16_t, 4, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_32FC1:
+                cv::parallel_for_(rows, RemapBody<float, 1, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_32FC3:
+                cv::parallel_for_(rows, RemapBody<float, 3, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            case CV_32FC4:
+                cv::parallel_for_(rows, RemapBody<float, 4, Sampler>(src, dst, sampler, interpolation));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief The SourceRowIndex struct keeps, for each band of destination rows,
+     * the range of source rows sampled by the band (empty when the band samples
+     * only outside the source), so a band can be remapped as soon as these rows
+     * of the source frame are available
+     */
+    struct SourceRowIndex {
+        int band_rows;
+        std::vector<cv::Range> source_rows;
+    };
+
+    /**
+     * @brief: Builds the source row index of remap maps
+     * @param sampler a source coordinates provider
+     * @param source_rows a number of source frame rows
+     * @param band_rows a number of destination rows in a band
+     * @param interpolation a sampling method, linear reads the row below as well
+     * @param index the built index
+     */
+    template <typename Sampler>
+    void build_source_row_index(const Sampler& sampler, int source_rows, int band_rows,
+                                RemapInterpolation interpolation, SourceRowIndex& index)
+    {
+        const cv::Size size = sampler.size();
+        index.band_rows = std::max(band_rows, 1);
+        index.source_rows.clear();
+        std::vector<float> src_x(static_cast<size_t>(size.width));
+        std::vector<float> src_y(static_cast<size_t>(size.width));
+        for (int band_start = 0; band_start < size.height; band_start += index.band_rows) {
+            const int band_end = std::min(band_start + index.band_rows, size.height);
+            int first = source_rows;
+            int last = -1;
+            for (int y = band_start; y < band_end; ++y) {
+                sampler.fill_row(y, src_x.data(), src_y.data());
+                for (int x = 0; x < size.width; ++x) {
+                    int y0 = 0;
+                    int y1 = 0;
+                    if (interpolation == RemapInterpolation::nearest) {
+                        y0 = static_cast<int>(std::floor(src_y[x] + 0.5f));
+                        y1 = y0;
+                    } else {
+                        y0 = static_cast<int>(std::floor(src_y[x]));
+                        y1 = y0 + 1;
+                    }
+                    if (y1 < 0 || y0 >= source_rows) {
+                        continue;
+                    }
+                    first = std::min(first, std::max(y0, 0));
+                    last = std::max(last, std::min(y1, source_rows - 1));
+                }
+            }
+            index.source_rows.push_back(last < first ? cv::Range(0, 0) : cv::Range(first, last + 1));
+        }
+    }
+
+    bool is_remap_type_supported(int type);
+    bool is_dense_remap_kernel_preferred(int type);
+    bool remap_frame(const cv::Mat& src, cv::Mat& dst, const cv::Mat& map1,
+                     const cv::Mat& map2, RemapInterpolation interpolation);
+    void remap_band(const cv::Mat& src, cv::Mat& dst, const cv::Mat& map1, const cv::Mat& map2,
+                    RemapInterpolation interpolation, const cv::Range& rows);
+}
+
+#endif // REMAP_KERNELS_H
@@ -0,0 +1,443 @@
+/**
+  @file shm_frame_ring.cpp
+  @brief A definitions of POSIX shared-memory frame ring used to export frames to other processes
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shm_frame_ring.h"
+
+
+using namespace camera_ns;
+
+/// slot headers and frame data start at cache line boundaries
+static const size_t shm_alignment = 64;
+
+/**
+ * @brief: Rounds a size up to the shm alignment
+ */
+static size_t align_size(size_t size)
+{
+    return (size + shm_alignment - 1) / shm_alignment * shm_alignment;
+}
+
+/**
+ * @brief: Returns a shm_open name of a segment, a leading slash is added if missing
+ * @param name a segment name
+ * @return: segment name
+ */
+std::string camera_ns::get_shm_segment_name(const std::string &name)
+{
+    if (name.empty() or name[0] == '/') {
+        return name;
+    }
+    return "/" + name;
+}
+
+/**
+ * @brief: Returns a distance between slots of a ring
+ * @param slot_bytes a maximal frame size kept in a slot [B]
+ * @return: slot stride [B]
+ */
+size_t camera_ns::get_shm_slot_stride(size_t slot_bytes)
+{
+    return align_size(sizeof(ShmSlotHeader)) + align_size(slot_bytes);
+}
+
+/**
+ * @brief: A constructor
+ */
+ShmFramePublisher::ShmFramePublisher()
+    : memory(nullptr), memory_size(0), header(nullptr)
+{
+}
+
+/**
+ * @brief: A destructor, closes and removes the segment
+ */
+ShmFramePublisher::~ShmFramePublisher()
+{
+    close();
+}
+
+/**
+ * @brief: Creates the shared memory segment. An existing segment with the same name
+ * is never replaced, as it may belong to a live publisher; a segment left by a crashed
+ * publisher has to be removed explicitly with remove().
+ * @param arg_name a segment name (e.g. "camera_raw")
+ * @param arg_slot_count a number of slots in the ring
+ * @param arg_slot_bytes a maximal frame size kept in a slot [B]
+ * @param arg_mode the segment permissions, owner only by default
+ * @return: false when the arguments are wrong, the segment exists or cannot be created
+ */
+bool ShmFramePublisher::create(const std::string &arg_name, uint32_t arg_slot_count,
+                               size_t arg_slot_bytes, mode_t arg_mode)
+{
+    close();
+    std::string segment_name = get_shm_segment_name(arg_name);
+    if (segment_name.size() < 2 or arg_slot_count == 0 or arg_slot_bytes == 0
+            or arg_slot_bytes > UINT32_MAX) {
+        return false;
+    }
+    size_t size = align_size(sizeof(ShmRingHeader)) + arg_slot_count * get_shm_slot_stride(arg_slot_bytes);
+    int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, arg_mode);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+    name = segment_name;
+    memory = mapped;
+    memory_size = size;
+    header = new (memory) ShmRingHeader();
+    header->magic = shm_ring_magic;
+    header->version = shm_ring_version;
+    header->slot_count = arg_slot_count;
+    header->slot_bytes = static_cast<uint32_t>(arg_slot_bytes);
+    header->write_index.store(0, std::memory_order_relaxed);
+    char* slots = static_cast<char*>(memory) + align_size(sizeof(ShmRingHeader));
+    for (uint32_t s = 0; s < arg_slot_count; ++s) {
+        ShmSlotHeader* slot = new (slots + s * get_shm_slot_stride(arg_slot_bytes)) ShmSlotHeader();
+        slot->lock.store(0, std::memory_order_relaxed);
+    }
+    header->open.store(1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief: Marks the segment closed for subscribers, unmaps and removes it
+ */
+void ShmFramePublisher::close()
+{
+    if (memory == nullptr) {
+        return;
+    }
+    header->open.store(0, std::memory_order_release);
+    munmap(memory, memory_size);
+    shm_unlink(name.c_str());
+    memory = nullptr;
+    memory_size = 0;
+    header = nullptr;
+    name.clear();
+}
+
+/**
+ * @brief: Removes a segment left by a publisher which did not close it (e.g. crashed),
+ * subscribers keep their mapping until they close it
+ * @param arg_name a segment name
+ * @return: false when there is no such segment or it cannot be removed
+ */
+bool ShmFramePublisher::remove(const std::string &arg_name)
+{
+    std::string segment_name = get_shm_segment_name(arg_name);
+    return segment_name.size() >= 2 and shm_unlink(segment_name.c_str()) == 0;
+}
+
+/**
+ * @brief: Check if a segment with the name exists
+ * @param arg_name a segment name
+ * @return: true when the segment exists, even if it cannot be opened by this process
+ */
+bool ShmFramePublisher::exists(const std::string &arg_name)
+{
+    std::string segment_name = get_shm_segment_name(arg_name);
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return errno == EACCES;
+    }
+    ::close(fd);
+    return true;
+}
+
+/**
+ * @brief: Copies a frame to the next slot of the ring
+ * @param frame a frame to publish
+ * @param frame_sequence a capture sequence number of the frame
+ * @return: false when the segment is not open, the frame is empty or bigger than a slot
+ */
+bool ShmFramePublisher::publish(const cv::Mat &frame, uint64_t frame_sequence)
+{
+    size_t row_bytes = frame.cols * frame.elemSize();
+    if (header == nullptr or frame.empty() or frame.dims > 2
+            or row_bytes * frame.rows > header->slot_bytes) {
+        return false;
+    }
+    uint64_t index = header->write_index.load(std::memory_order_relaxed);
+    uint32_t slot_number = static_cast<uint32_t>(index % header->slot_count);
+    char* slot_memory = static_cast<char*>(memory) + align_size(sizeof(ShmRingHeader))
+            + slot_number * get_shm_slot_stride(header->slot_bytes);
+    ShmSlotHeader* slot = reinterpret_cast<ShmSlotHeader*>(slot_memory);
+    char* data = slot_memory + align_size(sizeof(ShmSlotHeader));
+
+    uint64_t lock = slot->lock.load(std::memory_order_relaxed);
+    slot->lock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->frame_sequence = frame_sequence;
+    slot->rows = frame.rows;
+    slot->cols = frame.cols;
+    slot->type = frame.type();
+    slot->step = static_cast<uint32_t>(row_bytes);
+    if (frame.isContinuous()) {
+        std::memcpy(data, frame.data, row_bytes * frame.rows);
+    } else {
+        for (int r = 0; r < frame.rows; ++r) {
+            std::memcpy(data + r * row_bytes, frame.ptr(r), row_bytes);
+        }
+    }
+    slot->lock.store(lock + 2, std::memory_order_release);
+    header->write_index.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief: Check if the segment is open
+ * @return: open flag
+ */
+bool ShmFramePublisher::get_open() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief: Returns the segment name
+ * @return: segment name, empty when closed
+ */
+const std::string &ShmFramePublisher::get_name() const
+{
+    return name;
+}
+
+/**
+ * @brief: Returns the maximal frame size kept in a slot
+ * @return: slot size [B], 0 when closed
+ */
+size_t ShmFramePublisher::get_slot_bytes() const
+{
+    return header == nullptr ? 0 : header->slot_bytes;
+}
+
+/**
+ * @brief: A constructor
+ */
+ShmFrameSubscriber::ShmFrameSubscriber()
+    : memory(nullptr), memory_size(0), header(nullptr), slot_count(0), slot_bytes(0)
+{
+}
+
+/**
+ * @brief: A destructor, unmaps the segment
+ */
+ShmFrameSubscriber::~ShmFrameSubscriber()
+{
+    close();
+}
+
+/**
+ * @brief: Maps a segment created by ShmFramePublisher read-only
+ * @param arg_name a segment name
+ * @return: false when the segment does not exist or is not a frame ring
+ */
+bool ShmFrameSubscriber::open(const std::string &arg_name)
+{
+    close();
+    std::string segment_name = get_shm_segment_name(arg_name);
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat segment_status;
+    if (fstat(fd, &segment_status) != 0
+            or static_cast<size_t>(segment_status.st_size) < align_size(sizeof(ShmRingHeader))) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(segment_status.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    const ShmRingHeader* mapped_header = static_cast<const ShmRingHeader*>(mapped);
+    if (mapped_header->magic != shm_ring_magic or mapped_header->version != shm_ring_version
+            or mapped_header->slot_count == 0
+            or align_size(sizeof(ShmRingHeader))
+               + mapped_header->slot_count * get_shm_slot_stride(mapped_header->slot_bytes) > size) {
+        munmap(mapped, size);
+        return false;
+    }
+    memory = mapped;
+    memory_size = size;
+    header = mapped_header;
+    slot_count = mapped_header->slot_count;
+    slot_bytes = mapped_header->slot_bytes;
+    return true;
+}
+
+/**
+ * @brief: Unmaps the segment, frames mapped by map_latest must not be used anymore
+ */
+void ShmFrameSubscriber::close()
+{
+    if (memory == nullptr) {
+        return;
+    }
+    munmap(const_cast<void*>(memory), memory_size);
+    memory = nullptr;
+    memory_size = 0;
+    header = nullptr;
+    slot_count = 0;
+    slot_bytes = 0;
+}
+
+/**
+ * @brief: Check if the segment is mapped
+ * @return: open flag
+ */
+bool ShmFrameSubscriber::get_open() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief: Check if the publisher still writes to the mapped segment,
+ * when it does not the segment should be opened again
+ * @return: publisher open flag
+ */
+bool ShmFrameSubscriber::get_publisher_open() const
+{
+    return header != nullptr and header->open.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * @brief: Returns the number of frames published to the ring
+ * @return: write index, 0 when closed
+ */
+uint64_t ShmFrameSubscriber::get_write_index() const
+{
+    return header == nullptr ? 0 : header->write_index.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief: Checks a frame layout read from a slot header, which is written by
+ * another process, before a cv::Mat is built on the slot memory
+ * @return: true when the type is valid and the frame fits the slot
+ */
+static bool is_valid_slot_frame(int rows, int cols, int type, size_t step, uint32_t slot_bytes)
+{
+    if (rows <= 0 or cols <= 0 or type != CV_MAT_TYPE(type) or CV_MAT_DEPTH(type) > CV_64F) {
+        return false;
+    }
+    const uint64_t row_bytes = static_cast<uint64_t>(cols) * CV_ELEM_SIZE(type);
+    return row_bytes <= step and step % CV_ELEM_SIZE1(type) == 0
+            and static_cast<uint64_t>(step) * static_cast<uint64_t>(rows) <= slot_bytes;
+}
+
+/**
+ * @brief: Maps the latest published frame without copying. The frame is read-only
+ * and must be checked with validate() after use, the publisher may overwrite it
+ * after slot_count - 1 further frames.
+ * @param view the mapped frame
+ * @return: false when there is no complete frame or its slot header is not valid
+ */
+bool ShmFrameSubscriber::map_latest(ShmFrameView &view) const
+{
+    if (header == nullptr) {
+        return false;
+    }
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        uint64_t index = header->write_index.load(std::memory_order_acquire);
+        if (index == 0) {
+            return false;
+        }
+        uint32_t slot_number = static_cast<uint32_t>((index - 1) % slot_count);
+        const ShmSlotHeader* slot = get_slot(slot_number);
+        uint64_t lock = slot->lock.load(std::memory_order_acquire);
+        if (lock % 2 != 0) {
+            continue;
+        }
+        int rows = slot->rows;
+        int cols = slot->cols;
+        int type = slot->type;
+        size_t step = slot->step;
+        uint64_t frame_sequence = slot->frame_sequence;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->lock.load(std::memory_order_relaxed) != lock) {
+            continue;
+        }
+        if (is_valid_slot_frame(rows, cols, type, step, slot_bytes) == false) {
+            return false;
+        }
+        const char* data = reinterpret_cast<const char*>(slot) + align_size(sizeof(ShmSlotHeader));
+        view.frame = cv::Mat(rows, cols, type, const_cast<char*>(data), step);
+        view.frame_sequence = frame_sequence;
+        view.slot = slot_number;
+        view.lock = lock;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief: Check if a mapped frame was not overwritten by the publisher
+ * @param view a frame returned by map_latest
+ * @return: true when the frame content is still consistent
+ */
+bool ShmFrameSubscriber::validate(const ShmFrameView &view) const
+{
+    if (header == nullptr or view.slot >= slot_count) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return get_slot(view.slot)->lock.load(std::memory_order_relaxed) == view.lock;
+}
+
+/**
+ * @brief: Copies the latest published frame, retried when the publisher overwrites it meanwhile
+ * @param frame the copied frame
+ * @param frame_sequence the capture sequence number of the frame, may be nullptr
+ * @return: false when there is no complete frame
+ */
+bool ShmFrameSubscriber::copy_latest(cv::Mat &frame, uint64_t *frame_sequence) const
+{
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        ShmFrameView view;
+        if (map_latest(view) == false) {
+            return false;
+        }
+        view.frame.copyTo(frame);
+        if (validate(view)) {
+            if (frame_sequence != nullptr) {
+                *frame_sequence = view.frame_sequence;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief: Returns the header of a slot
+ */
+const ShmSlotHeader *ShmFrameSubscriber::get_slot(uint32_t slot) const
+{
+    return reinterpret_cast<const ShmSlotHeader*>(
+                static_cast<const char*>(memory) + align_size(sizeof(ShmRingHeader))
+                + slot * get_shm_slot_stride(slot_bytes));
+}
@@ -0,0 +1,127 @@
+/**
+  @file shm_frame_ring.h
+  @brief A declarations of POSIX shared-memory frame ring used to export frames to other processes
+  @author Michal Labowski
+  @date 18-10-2026
+  @version 1.0
+ */
+
+#ifndef SHM_FRAME_RING_H
+#define SHM_FRAME_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <opencv2/core.hpp>
+
+namespace camera_ns {
+    /**
+     * @brief The ShmRingHeader struct is placed at the beginning of the shared
+     * memory segment, slots follow it
+     */
+    struct ShmRingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t slot_bytes;
+        /// cleared by the publisher when the segment is closed or replaced
+        std::atomic<uint32_t> open;
+        /// number of published frames, the latest one is in slot (write_index - 1) % slot_count
+        std::atomic<uint64_t> write_index;
+    };
+
+    /**
+     * @brief The ShmSlotHeader struct describes a frame kept in a slot. lock is
+     * a seqlock: odd while the publisher writes the slot, increased to the next
+     * even value when the frame is complete.
+     */
+    struct ShmSlotHeader {
+        std::atomic<uint64_t> lock;
+        uint64_t frame_sequence;
+        int32_t rows;
+        int32_t cols;
+        int32_t type;
+        uint32_t step;
+    };
+
+    /**
+     * @brief The ShmFrameView struct keeps a frame mapped from a slot without copying,
+     * it stays valid until the publisher reuses the slot (see ShmFrameSubscriber::validate)
+     */
+    struct ShmFrameView {
+        cv::Mat frame;
+        uint64_t frame_sequence = 0;
+        uint32_t slot = 0;
+        uint64_t lock = 0;
+    };
+
+    /**
+     * @brief The ShmFramePublisher class writes frames to a POSIX shared-memory ring
+     * of slots. Single publisher per segment, publish() never waits for subscribers.
+     */
+    class ShmFramePublisher
+    {
+    public:
+        ShmFramePublisher();
+        ~ShmFramePublisher();
+        ShmFramePublisher(const ShmFramePublisher&) = delete;
+        ShmFramePublisher& operator=(const ShmFramePublisher&) = delete;
+
+        bool create(const std::string& arg_name, uint32_t arg_slot_count, size_t arg_slot_bytes,
+                    mode_t arg_mode = 0600);
+        void close();
+        static bool remove(const std::string& arg_name);
+        static bool exists(const std::string& arg_name);
+        bool publish(const cv::Mat& frame, uint64_t frame_sequence);
+        bool get_open() const;
+        const std::string& get_name() const;
+        size_t get_slot_bytes() const;
+
+    private:
+        std::string name;
+        void* memory;
+        size_t memory_size;
+        ShmRingHeader* header;
+    };
+
+    /**
+     * @brief The ShmFrameSubscriber class maps the ring created by ShmFramePublisher
+     * read-only and returns frames as cv::Mat headers pointing into shared memory
+     */
+    class ShmFrameSubscriber
+    {
+    public:
+        ShmFrameSubscriber();
+        ~ShmFrameSubscriber();
+        ShmFrameSubscriber(const ShmFrameSubscriber&) = delete;
+        ShmFrameSubscriber& operator=(const ShmFrameSubscriber&) = delete;
+
+        bool open(const std::string& arg_name);
+        void close();
+        bool get_open() const;
+        bool get_publisher_open() const;
+        uint64_t get_write_index() const;
+        bool map_latest(ShmFrameView& view) const;
+        bool validate(const ShmFrameView& view) const;
+        bool copy_latest(cv::Mat& frame, uint64_t* frame_sequence = nullptr) const;
+
+    private:
+        const void* memory;
+        size_t memory_size;
+        const ShmRingHeader* header;
+        /// the ring layout checked by open(), the shared header is not trusted afterwards
+        uint32_t slot_count;
+        uint32_t slot_bytes;
+
+        const ShmSlotHeader* get_slot(uint32_t slot) const;
+    };
+
+    const uint32_t shm_ring_magic = 0x43414d52;
+    const uint32_t shm_ring_version = 1;
+    std::string get_shm_segment_name(const std::string& name);
+    size_t get_shm_slot_stride(size_t slot_bytes);
+}
+
+#endif // SHM_FRAME_RING_H
@@ -0,0 +1,47 @@
+#include <sstream>
+#include <gtest/gtest.h>
+#include "calibration_data.h"
+
+static camera_ns::CalibrationData make_calibration_data()
+{
+    camera_ns::CalibrationData data;
+    data.cam_matrix = cv::Mat::eye(3, 3, CV_64F);
+    data.cam_matrix.at<double>(0, 0) = 1000.0;
+    data.cam_matrix.at<double>(1, 1) = 1000.0;
+    data.cam_matrix.at<double>(0, 2) = 959.5;
+    data.cam_matrix.at<double>(1, 2) = 539.5;
+    data.dist_coeffs = cv::Mat::zeros(5, 1, CV_64F);
+    data.dist_coeffs.at<double>(0) = -0.1;
+    data.frame_size = cv::Size(1920, 1080);
+    return data;
+}
+
+TEST(CalibrationDataTest, WriteAndReadBack)
+{
+    std::stringstream stream;
+    ASSERT_TRUE(camera_ns::write_calibration_data(stream, make_calibration_data()));
+
+    camera_ns::CalibrationData data;
+    ASSERT_TRUE(camera_ns::read_calibration_data(stream, data));
+    EXPECT_EQ(cv::Size(1920, 1080), data.frame_size);
+    EXPECT_DOUBLE_EQ(959.5, data.cam_matrix.at<double>(0, 2));
+    EXPECT_DOUBLE_EQ(-0.1, data.dist_coeffs.at<double>(0));
+}
+
+TEST(CalibrationDataTest, MalformedDataIsRejected)
+{
+    std::stringstream stream("3\n3\n1\n0\n");
+    camera_ns::CalibrationData data;
+    EXPECT_FALSE(camera_ns::read_calibration_data(stream, data));
+    EXPECT_TRUE(data.cam_matrix.empty());
+}
+
+TEST(CalibrationDataTest, ScaleCameraMatrix)
+{
+    camera_ns::CalibrationData data = make_calibration_data();
+    cv::Mat camera_matrix;
+    ASSERT_TRUE(camera_ns::scale_camera_matrix(data, cv::Size(960, 540), camera_matrix));
+    EXPECT_NEAR(500.0, camera_matrix.at<double>(0, 0), 1e-9);
+    EXPECT_NEAR(479.5, camera_matrix.at<double>(0, 2), 1e-9);
+    EXPECT_FALSE(camera_ns::scale_camera_matrix(data, cv::Size(640, 480), camera_matrix));
+}
@@ -0,0 +1,123 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "calibration_model.h"
+#include "camera.h"
+
+static camera_ns::CalibrationData make_calibration_data(double focal)
+{
+    camera_ns::CalibrationData data;
+    data.cam_matrix = (cv::Mat_<double>(3, 3) << focal, 0.0, 63.5, 0.0, focal, 35.5, 0.0, 0.0, 1.0);
+    data.dist_coeffs = (cv::Mat_<double>(5, 1) << -0.2, 0.05, 0.0, 0.0, 0.0);
+    data.frame_size = cv::Size(128, 72);
+    return data;
+}
+
+TEST(CalibrationModelTest, RegistrySharesModelsOfSameData)
+{
+    const size_t registry_size = camera_ns::CalibrationModel::get_registry_size();
+    std::shared_ptr<const camera_ns::CalibrationModel> first =
+            camera_ns::CalibrationModel::get(make_calibration_data(100.0));
+    std::shared_ptr<const camera_ns::CalibrationModel> second =
+            camera_ns::CalibrationModel::get(make_calibration_data(100.0));
+    std::shared_ptr<const camera_ns::CalibrationModel> other =
+            camera_ns::CalibrationModel::get(make_calibration_data(120.0));
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), other.get());
+    EXPECT_NE(first->get_hash(), other->get_hash());
+    EXPECT_EQ(registry_size + 2, camera_ns::CalibrationModel::get_registry_size());
+
+    first.reset();
+    second.reset();
+    other.reset();
+    EXPECT_EQ(registry_size, camera_ns::CalibrationModel::get_registry_size());
+}
+
+TEST(CalibrationModelTest, MapsAreBuiltOnce)
+{
+    std::shared_ptr<const camera_ns::CalibrationModel> model =
+            camera_ns::CalibrationModel::get(make_calibration_data(100.0));
+    cv::Mat first1, first2, second1, second2;
+    ASSERT_TRUE(model->get_dense_maps(cv::Size(64, 36), first1, first2));
+    ASSERT_TRUE(model->get_dense_maps(cv::Size(64, 36), second1, second2));
+    EXPECT_EQ(first1.data, second1.data);
+    EXPECT_EQ(cv::Size(64, 36), first1.size());
+    EXPECT_FALSE(model->get_dense_maps(cv::Size(64, 64), first1, first2));
+
+    std::shared_ptr<const camera_ns::CoarseRemapMap> compact =
+            model->get_compact_map(cv::Size(64, 36), 8, camera_ns::GridInterpolation::bilinear);
+    ASSERT_TRUE(static_cast<bool>(compact));
+    EXPECT_EQ(compact.get(), model->get_compact_map(cv::Size(64, 36), 8,
+                                                    camera_ns::GridInterpolation::bilinear).get());
+    EXPECT_EQ(1u, model->get_cached_sizes_count());
+}
+
+TEST(CalibrationModelTest, ConcurrentRequestsShareOneBuild)
+{
+    std::shared_ptr<const camera_ns::CalibrationModel> model =
+            camera_ns::CalibrationModel::get(make_calibration_data(110.0));
+    const int thread_count = 8;
+    std::vector<cv::Mat> maps(thread_count);
+    std::vector<std::shared_ptr<const camera_ns::CoarseRemapMap>> compact(thread_count);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        threads.push_back(std::thread([&, i]() {
+            cv::Mat map2;
+            /// half of the threads ask for another resolution, which is built meanwhile
+            model->get_dense_maps(i % 2 == 0 ? cv::Size(128, 72) : cv::Size(64, 36), maps[i], map2);
+            compact[i] = model->get_compact_map(cv::Size(128, 72), 8, camera_ns::GridInterpolation::bilinear);
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    for (int i = 2; i < thread_count; ++i) {
+        EXPECT_EQ(maps[i % 2].data, maps[i].data);
+        EXPECT_EQ(compact[0].get(), compact[i].get());
+    }
+    EXPECT_EQ(cv::Size(128, 72), maps[0].size());
+    EXPECT_EQ(cv::Size(64, 36), maps[1].size());
+    EXPECT_EQ(2u, model->get_cached_sizes_count());
+}
+
+TEST(CalibrationModelTest, SourceRowIndexIsKeptPerBandHeight)
+{
+    std::shared_ptr<const camera_ns::CalibrationModel> model =
+            camera_ns::CalibrationModel::get(make_calibration_data(100.0));
+    std::shared_ptr<const camera_ns::SourceRowIndex> first = model->get_source_row_index(cv::Size(64, 36), 8);
+    ASSERT_TRUE(static_cast<bool>(first));
+    EXPECT_EQ(8, first->band_rows);
+    EXPECT_EQ(5u, first->source_rows.size());
+    EXPECT_EQ(first.get(), model->get_source_row_index(cv::Size(64, 36), 8).get());
+
+    /// cameras streaming with other band heights do not drop the index, oversized bands are limited to the frame
+    std::shared_ptr<const camera_ns::SourceRowIndex> whole = model->get_source_row_index(cv::Size(64, 36), 1000);
+    ASSERT_TRUE(static_cast<bool>(whole));
+    EXPECT_EQ(36, whole->band_rows);
+    EXPECT_EQ(1u, whole->source_rows.size());
+    EXPECT_EQ(whole.get(), model->get_source_row_index(cv::Size(64, 36), 36).get());
+    EXPECT_EQ(first.get(), model->get_source_row_index(cv::Size(64, 36), 8).get());
+    EXPECT_FALSE(static_cast<bool>(model->get_source_row_index(cv::Size(64, 64), 8)));
+}
+
+TEST(CalibrationModelTest, CamerasShareModelAndMaps)
+{
+    camera_ns::Camera first;
+    camera_ns::Camera second;
+    EXPECT_TRUE(first.set_calibration_model(camera_ns::CalibrationModel::get(make_calibration_data(100.0))));
+    EXPECT_TRUE(second.set_calibration_model(camera_ns::CalibrationModel::get(make_calibration_data(100.0))));
+    EXPECT_FALSE(second.set_calibration_model(std::shared_ptr<const camera_ns::CalibrationModel>()));
+    EXPECT_EQ(first.get_calibration_model().get(), second.get_calibration_model().get());
+    EXPECT_EQ(true, second.get_calibrated());
+
+    first.get_reference_to_frame_raw() = cv::Mat(36, 64, CV_8UC1, cv::Scalar(50));
+    second.get_reference_to_frame_raw() = cv::Mat(36, 64, CV_8UC1, cv::Scalar(50));
+    first.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(1u, second.get_remap_cache_size());
+    second.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(1u, first.get_remap_cache_size());
+
+    /// the returned calibration data is a copy, the shared model cannot be modified
+    first.get_camera_matrix().at<double>(0, 0) = 1.0;
+    EXPECT_DOUBLE_EQ(100.0, second.get_camera_matrix().at<double>(0, 0));
+}
@@ -1,6 +1,49 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 #include <gtest/gtest.h>
+#include <opencv2/calib3d.hpp>
 #include "camera.h"
 
+/**
+ * @brief The TempFile class reserves a unique file in the temporary
+ * directory and removes it when the test ends
+ */
+class TempFile
+{
+public:
+    TempFile()
+    {
+        const char* directory = std::getenv("TMPDIR");
+        std::string pattern = std::string(directory != nullptr ? directory : "/tmp") + "/camera_test_XXXXXX";
+        int fd = mkstemp(&pattern[0]);
+        if (fd >= 0) {
+            ::close(fd);
+            path = pattern;
+        }
+    }
+    ~TempFile()
+    {
+        if (path.empty() == false) {
+            std::remove(path.c_str());
+        }
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    const std::string& get_path() const
+    {
+        return path;
+    }
+
+private:
+    std::string path;
+};
+
 TEST(CameraTest, DefaultConstructor)
 {
     camera_ns::Camera cam;
@@ -84,3 +127,421 @@ TEST(CameraTest, LoadCameraDataFromFile)
     }
     ASSERT_EQ(catch_exception, true);
 }
+
+static void write_calibration_file(const std::string& file_name, bool with_resolution)
+{
+    std::ofstream out_stream(file_name);
+    out_stream << 3 << std::endl << 3 << std::endl;
+    double cam_matrix[] = {1000.0, 0.0, 959.5, 0.0, 1000.0, 539.5, 0.0, 0.0, 1.0};
+    for (double value : cam_matrix) {
+        out_stream << value << std::endl;
+    }
+    out_stream << 5 << std::endl << 1 << std::endl;
+    double dist_coeffs[] = {-0.1, 0.01, 0.0, 0.0, 0.0};
+    for (double value : dist_coeffs) {
+        out_stream << value << std::endl;
+    }
+    if (with_resolution) {
+        out_stream << 1920 << std::endl << 1080 << std::endl;
+    }
+}
+
+static void write_raw_frames(const std::string& file_name, const std::vector<cv::Mat>& frames)
+{
+    std::ofstream out_stream(file_name, std::ios::binary);
+    for (const cv::Mat& frame : frames) {
+        out_stream.write(reinterpret_cast<const char*>(frame.data), frame.total() * frame.elemSize());
+    }
+}
+
+TEST(CameraTest, LoadCalibrationResolution)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(cv::Size(), cam.get_calibration_frame_size());
+
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    EXPECT_EQ(cv::Size(1920, 1080), cam.get_calibration_frame_size());
+    EXPECT_EQ(true, cam.get_calibrated());
+
+    TempFile legacy_file;
+    write_calibration_file(legacy_file.get_path(), false);
+    cam.set_camera_calibration_results_file_name(legacy_file.get_path());
+    cam.load_camera_calibration_data();
+    EXPECT_EQ(cv::Size(), cam.get_calibration_frame_size());
+    EXPECT_DOUBLE_EQ(-0.1, cam.get_dist_coefs().at<double>(0, 0));
+}
+
+TEST(CameraTest, ScaleCameraMatrixToCaptureResolution)
+{
+    camera_ns::Camera cam;
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+
+    cv::Mat scaled = cam.get_camera_matrix_for_size(cv::Size(1280, 720));
+    EXPECT_NEAR(1000.0 * 2.0 / 3.0, scaled.at<double>(0, 0), 1e-9);
+    EXPECT_NEAR(1000.0 * 2.0 / 3.0, scaled.at<double>(1, 1), 1e-9);
+    EXPECT_NEAR(639.5, scaled.at<double>(0, 2), 1e-9);
+    EXPECT_NEAR(359.5, scaled.at<double>(1, 2), 1e-9);
+    EXPECT_DOUBLE_EQ(1000.0, cam.get_camera_matrix().at<double>(0, 0));
+
+    bool catch_exception = false;
+    try {
+        cam.get_camera_matrix_for_size(cv::Size(640, 480));
+    } catch (camera_ns::ExceptionMessage em) {
+        EXPECT_EQ(camera_ns::ExceptionID::calibration_resolution_mismatch, em.id);
+        catch_exception = true;
+    }
+    ASSERT_EQ(catch_exception, true);
+}
+
+TEST(CameraTest, DefaultCalibrationEstimatesK3)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(camera_ns::DistortionModel::radial3_tangential, cam.get_distortion_model());
+    EXPECT_EQ(0, camera_ns::get_distortion_model_flags(cam.get_distortion_model()) & cv::CALIB_FIX_K3);
+
+    cam.set_chessboard_dimensions(9, 6);
+    cam.set_chessboard_square_dimension(0.025f);
+    const cv::Size size(1280, 720);
+    const cv::Mat camera_matrix = (cv::Mat_<double>(3, 3) << 900.0, 0.0, 639.5, 0.0, 900.0, 359.5, 0.0, 0.0, 1.0);
+    const cv::Mat dist_coeffs = (cv::Mat_<double>(1, 5) << -0.28, 0.09, 0.0008, -0.0005, -0.02);
+    const std::vector<cv::Point3f> board = cam.get_known_board_positions();
+
+    /// noise-free views of a tilted board spread over the whole frame
+    std::vector<std::vector<cv::Point2f>> views;
+    for (int i = 0; i < 12; ++i) {
+        const double x = (i % 4 - 1.5) * 0.1 - 0.1;
+        const double y = (i / 4 - 1.0) * 0.08 - 0.0625;
+        cv::Mat rvec = (cv::Mat_<double>(3, 1) << (i % 2 == 0 ? 0.3 : -0.3), (i % 3 - 1) * 0.3, 0.05 * i);
+        cv::Mat tvec = (cv::Mat_<double>(3, 1) << x, y, 0.45);
+        std::vector<cv::Point2f> points;
+        cv::projectPoints(board, rvec, tvec, camera_matrix, dist_coeffs, points);
+        views.push_back(points);
+    }
+    cam.calibrate_from_image_points(views, size);
+    cv::Mat estimated = cam.get_dist_coefs();
+    ASSERT_GE(estimated.total(), 5u);
+    EXPECT_NEAR(-0.02, estimated.at<double>(4), 0.005);
+    EXPECT_NEAR(-0.28, estimated.at<double>(0), 0.005);
+}
+
+TEST(CameraTest, TryReadWrongIdReturnsStatus)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(camera_ns::ExceptionID::camera_wrong_id, cam.try_read());
+    EXPECT_EQ(camera_ns::ExceptionID::camera_wrong_id, cam.try_read());
+    EXPECT_EQ(2u, cam.get_error_count(camera_ns::ExceptionID::camera_wrong_id));
+    EXPECT_EQ(0u, cam.get_error_count(camera_ns::ExceptionID::camera_reading_failure));
+
+    cam.reset_error_counters();
+    EXPECT_EQ(0u, cam.get_error_count(camera_ns::ExceptionID::camera_wrong_id));
+}
+
+TEST(CameraTest, TryCompensateDistortionsReturnsStatus)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(camera_ns::ExceptionID::no_calibration_data,
+              cam.try_compensate_distortions(camera_ns::CorrectionType::remap));
+
+    cam.set_calibrated(true);
+    EXPECT_EQ(camera_ns::ExceptionID::empty_frame,
+              cam.try_compensate_distortions(camera_ns::CorrectionType::remap));
+    EXPECT_EQ(1u, cam.get_error_count(camera_ns::ExceptionID::empty_frame));
+}
+
+TEST(CameraTest, TryCompensateDistortionsResolutionMismatch)
+{
+    /// values of the baseline enumerators are kept, ok is appended
+    EXPECT_EQ(0, static_cast<int>(camera_ns::ExceptionID::camera_open_failure));
+    EXPECT_EQ(11, static_cast<int>(camera_ns::ExceptionID::empty_frame));
+    EXPECT_EQ(camera_ns::exception_id_count, static_cast<size_t>(camera_ns::ExceptionID::ok));
+
+    camera_ns::Camera cam;
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    cam.get_reference_to_frame_raw() = cv::Mat(48, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    const camera_ns::CorrectionType types[] = {camera_ns::CorrectionType::remap,
+                                               camera_ns::CorrectionType::remap_compact,
+                                               camera_ns::CorrectionType::undistort};
+    for (camera_ns::CorrectionType ct : types) {
+        EXPECT_EQ(camera_ns::ExceptionID::calibration_resolution_mismatch, cam.try_compensate_distortions(ct));
+    }
+    EXPECT_EQ(3u, cam.get_error_count(camera_ns::ExceptionID::calibration_resolution_mismatch));
+    EXPECT_EQ(0u, cam.get_error_count(camera_ns::ExceptionID::ok));
+
+    bool catch_exception = false;
+    try {
+        cam.compensate_distortions(camera_ns::CorrectionType::remap);
+    } catch (camera_ns::ExceptionMessage em) {
+        EXPECT_EQ(camera_ns::ExceptionID::calibration_resolution_mismatch, em.id);
+        catch_exception = true;
+    }
+    ASSERT_EQ(catch_exception, true);
+}
+
+TEST(CameraTest, ReloadCalibrationAppliedAtFrameBoundary)
+{
+    camera_ns::Camera cam;
+    camera_ns::CalibrationData data;
+    data.cam_matrix = cv::Mat::eye(3, 3, CV_64F);
+    data.cam_matrix.at<double>(0, 0) = 800.0;
+    data.dist_coeffs = cv::Mat::zeros(5, 1, CV_64F);
+    cam.reload_calibration(data);
+
+    for (int i = 0; i < 200 and cam.get_calibration_update_pending() == false; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(true, cam.get_calibration_update_pending());
+    EXPECT_EQ(0u, cam.get_calibration_version());
+    EXPECT_DOUBLE_EQ(1.0, cam.get_camera_matrix().at<double>(0, 0));
+
+    /// no frame was captured, but the update is applied before the frame checks
+    EXPECT_EQ(camera_ns::ExceptionID::empty_frame,
+              cam.try_compensate_distortions(camera_ns::CorrectionType::remap));
+    EXPECT_EQ(1u, cam.get_calibration_version());
+    EXPECT_EQ(true, cam.get_calibrated());
+    EXPECT_DOUBLE_EQ(800.0, cam.get_camera_matrix().at<double>(0, 0));
+    cam.stop_calibration_reload();
+}
+
+TEST(CameraTest, LazyCompensationRunsOnRequest)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(false, cam.get_lazy_compensation());
+    EXPECT_EQ(0u, cam.get_capture_sequence());
+    EXPECT_EQ(0u, cam.get_duplicate_frames_count());
+
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    cam.set_lazy_compensation(true);
+    cam.get_reference_to_frame_raw() = cv::Mat(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+
+    cam.compensate_distortions(camera_ns::CorrectionType::remap);
+    cv::Mat compensated = cam.get_frame_calibrated();
+    EXPECT_EQ(cv::Size(64, 36), compensated.size());
+    EXPECT_EQ(0u, cam.get_error_count(camera_ns::ExceptionID::correction_failure));
+}
+
+TEST(CameraTest, FrameBudgetMeasuresCorrectionCost)
+{
+    camera_ns::Camera cam;
+    EXPECT_EQ(0, cam.get_frame_budget().count());
+    EXPECT_EQ(camera_ns::CorrectionQuality::full, cam.get_correction_quality());
+    EXPECT_EQ(false, cam.set_frame_budget(std::chrono::microseconds(-1)));
+    EXPECT_EQ(true, cam.set_frame_budget(std::chrono::microseconds(1)));
+    EXPECT_EQ(1, cam.get_frame_budget().count());
+
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    cam.get_reference_to_frame_raw() = cv::Mat(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+
+    /// the first frame builds the maps, it is not measured
+    cam.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(cv::Size(64, 36), cam.get_frame_calibrated().size());
+    EXPECT_EQ(0.0, cam.get_correction_cost());
+    cam.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_GT(cam.get_correction_cost(), 0.0);
+    /// a single measurement does not change the level
+    EXPECT_EQ(camera_ns::CorrectionQuality::full, cam.get_correction_quality());
+}
+
+TEST(CameraTest, FrameBudgetStepsDownToAlternateFrames)
+{
+    camera_ns::Camera cam;
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    cam.set_frame_budget(std::chrono::microseconds(1));
+
+    /// every level is kept for 5 frames before the next decision
+    cv::Mat frame(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    for (int i = 0; i < 40; ++i) {
+        cam.get_reference_to_frame_raw() = frame.clone();
+        cam.compensate_distortions(camera_ns::CorrectionType::undistort);
+    }
+    EXPECT_EQ(camera_ns::CorrectionQuality::alternate_frames, cam.get_correction_quality());
+    EXPECT_GT(cam.get_dropped_compensations_count(), 0u);
+    /// budget drops are not counted as frames already compensated
+    EXPECT_EQ(0u, cam.get_skipped_compensations_count());
+}
+
+/**
+ * @brief: Streams a frame band by band and checks the bands against the full-frame correction
+ */
+static void expect_streaming_matches_full_frame(const cv::Mat& frame,
+                                                std::shared_ptr<const camera_ns::CalibrationModel> model,
+                                                int band_rows)
+{
+    TempFile stream_file;
+    write_raw_frames(stream_file.get_path(), {frame});
+    camera_ns::Camera cam;
+    ASSERT_TRUE(cam.set_calibration_model(model));
+
+    camera_ns::RawFrameSource source(frame.size(), frame.type(), 4);
+    ASSERT_TRUE(source.open(stream_file.get_path()));
+    cv::Mat streamed(frame.size(), frame.type(), cv::Scalar::all(0));
+    int next_row = 0;
+    ASSERT_TRUE(cam.compensate_streaming(source, [&](const cv::Mat& band, int first_row) {
+        EXPECT_EQ(next_row, first_row);
+        band.copyTo(streamed.rowRange(first_row, first_row + band.rows));
+        next_row = first_row + band.rows;
+    }, band_rows));
+    EXPECT_EQ(frame.rows, next_row);
+    EXPECT_EQ(1u, cam.get_capture_sequence());
+    EXPECT_EQ(0, cv::norm(frame, cam.get_frame_raw(), cv::NORM_INF));
+    EXPECT_FALSE(cam.compensate_streaming(source, camera_ns::BandHandler(), band_rows));
+
+    camera_ns::Camera reference;
+    ASSERT_TRUE(reference.set_calibration_model(model));
+    reference.get_reference_to_frame_raw() = frame.clone();
+    reference.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(0, cv::norm(reference.get_frame_calibrated(), streamed, cv::NORM_INF)) << "type " << frame.type();
+    EXPECT_EQ(0, cv::norm(reference.get_frame_calibrated(), cam.get_frame_calibrated(), cv::NORM_INF));
+}
+
+/**
+ * @brief: Returns the model of the calibration file written by write_calibration_file()
+ */
+static std::shared_ptr<const camera_ns::CalibrationModel> load_calibration_model()
+{
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    camera_ns::Camera cam;
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    return cam.get_calibration_model();
+}
+
+TEST(CameraTest, FrameEditedThroughReferenceIsCompensatedAgain)
+{
+    cv::Mat frame(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    TempFile stream_file;
+    write_raw_frames(stream_file.get_path(), {frame});
+    camera_ns::Camera cam;
+    ASSERT_TRUE(cam.set_calibration_model(load_calibration_model()));
+    camera_ns::RawFrameSource source(frame.size(), frame.type(), 4);
+    ASSERT_TRUE(source.open(stream_file.get_path()));
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler(), 8));
+    ASSERT_EQ(1u, cam.get_capture_sequence());
+
+    /// the frame keeps its sequence number, but its content is changed by the caller
+    cam.get_reference_to_frame_raw().setTo(cv::Scalar(200, 100, 50));
+    cam.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(0u, cam.get_skipped_compensations_count());
+
+    camera_ns::Camera reference;
+    ASSERT_TRUE(reference.set_calibration_model(cam.get_calibration_model()));
+    reference.get_reference_to_frame_raw() = cv::Mat(36, 64, CV_8UC3, cv::Scalar(200, 100, 50));
+    reference.compensate_distortions(camera_ns::CorrectionType::remap);
+    EXPECT_EQ(0, cv::norm(reference.get_frame_calibrated(), cam.get_frame_calibrated(), cv::NORM_INF));
+}
+
+TEST(CameraTest, SharedMemoryExportStopsWhenRingIsTaken)
+{
+    const std::string name = "test_camera_export_" + std::to_string(getpid());
+    camera_ns::ShmFramePublisher::remove(name + "_raw");
+    cv::Mat frame(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    TempFile stream_file;
+    write_raw_frames(stream_file.get_path(), {frame, frame});
+
+    camera_ns::Camera cam;
+    ASSERT_TRUE(cam.set_calibration_model(load_calibration_model()));
+    ASSERT_TRUE(cam.enable_shared_memory_export(name, true, false));
+    /// another publisher takes the name before the first frame creates the ring
+    camera_ns::ShmFramePublisher other_publisher;
+    ASSERT_TRUE(other_publisher.create(name + "_raw", 2, 16));
+    EXPECT_FALSE(camera_ns::Camera().enable_shared_memory_export(name, true, false));
+
+    camera_ns::RawFrameSource source(frame.size(), frame.type(), 4);
+    ASSERT_TRUE(source.open(stream_file.get_path()));
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler(), 8));
+    EXPECT_EQ(1u, cam.get_error_count(camera_ns::ExceptionID::shared_memory_export_failure));
+    EXPECT_FALSE(cam.get_shared_memory_export());
+    /// the failure is not retried with later frames
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler(), 8));
+    EXPECT_EQ(1u, cam.get_error_count(camera_ns::ExceptionID::shared_memory_export_failure));
+    EXPECT_EQ(16u, other_publisher.get_slot_bytes());
+}
+
+TEST(CameraTest, StreamingCompensationMatchesFullFrame)
+{
+    /// 8-bit frames are remapped by openCV, 16UC1 by the kernel, 16SC1 has no kernel
+    const int types[] = {CV_8UC3, CV_16UC1, CV_16SC1};
+    for (int type : types) {
+        cv::Mat frame(36, 64, type);
+        cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+        expect_streaming_matches_full_frame(frame, load_calibration_model(), 8);
+    }
+}
+
+TEST(CameraTest, StreamingTruncatedFrameKeepsPreviousFrame)
+{
+    cv::Mat first(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    cv::Mat second(36, 64, CV_8UC3, cv::Scalar(200, 100, 50));
+    TempFile stream_file;
+    /// the source ends in the middle of the second frame
+    write_raw_frames(stream_file.get_path(), {first, second.rowRange(0, 20)});
+
+    camera_ns::Camera cam;
+    ASSERT_TRUE(cam.set_calibration_model(load_calibration_model()));
+    camera_ns::RawFrameSource source(first.size(), first.type(), 4);
+    ASSERT_TRUE(source.open(stream_file.get_path()));
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler(), 8));
+    cv::Mat compensated = cam.get_frame_calibrated().clone();
+
+    bool catch_exception = false;
+    try {
+        cam.compensate_streaming(source, camera_ns::BandHandler(), 8);
+    } catch (camera_ns::ExceptionMessage em) {
+        EXPECT_EQ(camera_ns::ExceptionID::camera_reading_failure, em.id);
+        catch_exception = true;
+    }
+    ASSERT_EQ(catch_exception, true);
+    /// the torn frame is not published, the previous frames stay consistent
+    EXPECT_EQ(1u, cam.get_capture_sequence());
+    EXPECT_EQ(0, cv::norm(first, cam.get_frame_raw(), cv::NORM_INF));
+    EXPECT_EQ(0, cv::norm(compensated, cam.get_frame_calibrated(), cv::NORM_INF));
+}
+
+TEST(CameraTest, DuplicateFrameHashingSeesEveryRow)
+{
+    cv::Mat first(36, 64, CV_8UC3, cv::Scalar(10, 20, 30));
+    cv::Mat second = first.clone();
+    /// a change confined to a single row
+    second.at<cv::Vec3b>(1, 5) = cv::Vec3b(200, 200, 200);
+    TempFile stream_file;
+    write_raw_frames(stream_file.get_path(), {first, second, second});
+
+    camera_ns::Camera cam;
+    TempFile calib_file;
+    write_calibration_file(calib_file.get_path(), true);
+    cam.set_camera_calibration_results_file_name(calib_file.get_path());
+    cam.load_camera_calibration_data();
+    EXPECT_EQ(false, cam.get_duplicate_frame_hashing());
+    cam.set_duplicate_frame_skipping(true);
+    cam.set_duplicate_frame_hashing(true);
+
+    camera_ns::RawFrameSource source(first.size(), first.type());
+    ASSERT_TRUE(source.open(stream_file.get_path()));
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler()));
+    EXPECT_EQ(1u, cam.get_capture_sequence());
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler()));
+    EXPECT_EQ(2u, cam.get_capture_sequence());
+    EXPECT_EQ(false, cam.get_last_frame_duplicate());
+    ASSERT_TRUE(cam.compensate_streaming(source, camera_ns::BandHandler()));
+    EXPECT_EQ(2u, cam.get_capture_sequence());
+    EXPECT_EQ(true, cam.get_last_frame_duplicate());
+    EXPECT_EQ(1u, cam.get_duplicate_frames_count());
+}
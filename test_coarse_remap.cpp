@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <opencv2/calib3d.hpp>
+#include "coarse_remap.h"
+
+static cv::Mat make_camera_matrix()
+{
+    cv::Mat camera_matrix = cv::Mat::eye(3, 3, CV_64F);
+    camera_matrix.at<double>(0, 0) = 500.0;
+    camera_matrix.at<double>(1, 1) = 500.0;
+    camera_matrix.at<double>(0, 2) = 319.5;
+    camera_matrix.at<double>(1, 2) = 239.5;
+    return camera_matrix;
+}
+
+static float measure_error(const cv::Mat& dist_coeffs, int grid_step,
+                           camera_ns::GridInterpolation interpolation)
+{
+    cv::Size size(640, 480);
+    cv::Mat camera_matrix = make_camera_matrix();
+    cv::Mat new_camera_matrix = cv::getOptimalNewCameraMatrix(camera_matrix, dist_coeffs,
+                                                              size, 1, size);
+    cv::Mat map_x, map_y;
+    cv::initUndistortRectifyMap(camera_matrix, dist_coeffs, cv::Mat(), new_camera_matrix,
+                                size, CV_32FC1, map_x, map_y);
+    camera_ns::CoarseRemapMap compact;
+    compact.build(camera_matrix, dist_coeffs, new_camera_matrix, size, grid_step, interpolation);
+    EXPECT_EQ(size, compact.size());
+    EXPECT_LT(compact.get_memory_size(), map_x.total() * map_x.elemSize());
+    return compact.max_error(map_x, map_y);
+}
+
+TEST(CoarseRemapTest, NoDistortionIsExact)
+{
+    cv::Mat dist_coeffs = cv::Mat::zeros(5, 1, CV_64F);
+    EXPECT_LT(measure_error(dist_coeffs, 16, camera_ns::GridInterpolation::bilinear), 1e-3f);
+}
+
+TEST(CoarseRemapTest, SmoothDistortionErrorIsSmall)
+{
+    cv::Mat dist_coeffs = cv::Mat::zeros(5, 1, CV_64F);
+    dist_coeffs.at<double>(0) = -0.25;
+    dist_coeffs.at<double>(1) = 0.08;
+    dist_coeffs.at<double>(2) = 0.001;
+    float bilinear = measure_error(dist_coeffs, 8, camera_ns::GridInterpolation::bilinear);
+    float bicubic = measure_error(dist_coeffs, 8, camera_ns::GridInterpolation::bicubic);
+    EXPECT_LT(bilinear, 0.5f);
+    EXPECT_LT(bicubic, 0.05f);
+    EXPECT_LT(bicubic, bilinear);
+}
+
+TEST(CoarseRemapTest, RemapFrameMatchesOutputSize)
+{
+    cv::Size size(64, 48);
+    cv::Mat camera_matrix = make_camera_matrix();
+    cv::Mat dist_coeffs = cv::Mat::zeros(5, 1, CV_64F);
+    camera_ns::CoarseRemapMap compact;
+    compact.build(camera_matrix, dist_coeffs, camera_matrix, size, 8,
+                  camera_ns::GridInterpolation::bilinear);
+
+    cv::Mat src(size, CV_16UC1, cv::Scalar(1000));
+    cv::Mat dst;
+    ASSERT_TRUE(camera_ns::remap_frame(src, dst, compact, camera_ns::RemapInterpolation::linear));
+    EXPECT_EQ(size, dst.size());
+    EXPECT_EQ(1000, dst.at<uint16_t>(20, 30));
+}
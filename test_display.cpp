@@ -0,0 +1,57 @@
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include "display.h"
+
+TEST(DisplayTest, MailboxKeepsLatestFrames)
+{
+    camera_ns::FrameMailbox mailbox;
+    cv::Mat raw;
+    cv::Mat compensated;
+    EXPECT_FALSE(mailbox.take(raw, compensated));
+
+    mailbox.post(cv::Mat(4, 4, CV_8UC1, cv::Scalar(1)), cv::Mat(4, 4, CV_8UC1, cv::Scalar(2)));
+    mailbox.post(cv::Mat(4, 4, CV_8UC1, cv::Scalar(3)), cv::Mat());
+    ASSERT_TRUE(mailbox.take(raw, compensated));
+    EXPECT_EQ(3, raw.at<uchar>(0, 0));
+    EXPECT_TRUE(compensated.empty());
+    EXPECT_FALSE(mailbox.take(raw, compensated));
+}
+
+TEST(DisplayTest, HeadlessServiceShowsPostedFrames)
+{
+    camera_ns::DisplayService display(std::unique_ptr<camera_ns::DisplayBackend>(
+                                          new camera_ns::NullDisplayBackend()));
+    EXPECT_FALSE(display.set_max_refresh_rate(0.0));
+    EXPECT_TRUE(display.set_max_refresh_rate(200.0));
+    display.start();
+    EXPECT_TRUE(display.get_running());
+
+    cv::Mat frame(8, 8, CV_8UC3, cv::Scalar(0, 0, 0));
+    for (int i = 0; i < 100 and display.get_shown_frames_count() == 0; ++i) {
+        display.post(frame, frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    display.stop();
+    EXPECT_FALSE(display.get_running());
+    EXPECT_GT(display.get_shown_frames_count(), 0u);
+    EXPECT_EQ(-1, display.get_last_key());
+}
+
+TEST(DisplayTest, RefreshShowsFramesOnCallingThread)
+{
+    camera_ns::DisplayService display(std::unique_ptr<camera_ns::DisplayBackend>(
+                                          new camera_ns::NullDisplayBackend()));
+    display.set_max_refresh_rate(1.0);
+    EXPECT_FALSE(display.refresh());
+
+    cv::Mat frame(8, 8, CV_8UC3, cv::Scalar(0, 0, 0));
+    display.post(frame, frame);
+    EXPECT_TRUE(display.refresh());
+    EXPECT_EQ(1u, display.get_shown_frames_count());
+    /// the next refresh is due in a second
+    display.post(frame, frame);
+    EXPECT_FALSE(display.refresh());
+    EXPECT_EQ(1u, display.get_shown_frames_count());
+    display.stop();
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <opencv2/calib3d.hpp>
+#include "distortion_model.h"
+
+static cv::Mat make_camera_matrix()
+{
+    return (cv::Mat_<double>(3, 3) << 300.0, 0.0, 159.5, 0.0, 300.0, 119.5, 0.0, 0.0, 1.0);
+}
+
+TEST(DistortionModelTest, InfersCheapestModel)
+{
+    camera_ns::DistortionModel model;
+    EXPECT_TRUE(camera_ns::infer_distortion_model(
+                    (cv::Mat_<double>(1, 5) << -0.2, 0.05, 0.0, 0.0, 0.0), model));
+    EXPECT_EQ(camera_ns::DistortionModel::radial2, model);
+    EXPECT_TRUE(camera_ns::infer_distortion_model(
+                    (cv::Mat_<double>(1, 5) << -0.2, 0.05, 0.001, 0.0, 0.0), model));
+    EXPECT_EQ(camera_ns::DistortionModel::radial_tangential, model);
+    EXPECT_TRUE(camera_ns::infer_distortion_model(
+                    (cv::Mat_<double>(1, 5) << -0.2, 0.05, 0.001, 0.0, -0.01), model));
+    EXPECT_EQ(camera_ns::DistortionModel::radial3_tangential, model);
+    EXPECT_TRUE(camera_ns::infer_distortion_model(
+                    (cv::Mat_<double>(8, 1) << -0.2, 0.05, 0.0, 0.0, 0.0, 0.01, 0.0, 0.0), model));
+    EXPECT_EQ(camera_ns::DistortionModel::rational, model);
+    cv::Mat thin_prism = cv::Mat::zeros(12, 1, CV_64F);
+    thin_prism.at<double>(9) = 0.001;
+    EXPECT_TRUE(camera_ns::infer_distortion_model(thin_prism, model));
+    EXPECT_EQ(camera_ns::DistortionModel::thin_prism, model);
+
+    cv::Mat tilted = cv::Mat::zeros(14, 1, CV_64F);
+    tilted.at<double>(13) = 0.01;
+    EXPECT_FALSE(camera_ns::infer_distortion_model(tilted, model));
+    EXPECT_FALSE(camera_ns::infer_distortion_model(cv::Mat::zeros(3, 3, CV_64F), model));
+}
+
+TEST(DistortionModelTest, MapsMatchOpenCV)
+{
+    const cv::Size size(320, 240);
+    const cv::Mat camera_matrix = make_camera_matrix();
+    std::vector<cv::Mat> coeffs;
+    coeffs.push_back((cv::Mat_<double>(1, 5) << -0.25, 0.08, 0.0, 0.0, 0.0));
+    coeffs.push_back((cv::Mat_<double>(1, 5) << -0.25, 0.08, 0.001, -0.0005, 0.0));
+    coeffs.push_back((cv::Mat_<double>(1, 5) << -0.25, 0.08, 0.001, -0.0005, -0.01));
+    coeffs.push_back((cv::Mat_<double>(1, 8) << -0.25, 0.08, 0.001, -0.0005, -0.01, 0.02, -0.01, 0.005));
+    coeffs.push_back((cv::Mat_<double>(1, 12) << -0.25, 0.08, 0.001, -0.0005, -0.01, 0.02, -0.01, 0.005,
+                      0.001, -0.0005, 0.0007, 0.0002));
+    for (size_t i = 0; i < coeffs.size(); ++i) {
+        cv::Mat new_camera_matrix = cv::getOptimalNewCameraMatrix(camera_matrix, coeffs[i], size, 1, size);
+        cv::Mat expected_x, expected_y, map_x, map_y;
+        cv::initUndistortRectifyMap(camera_matrix, coeffs[i], cv::Mat(), new_camera_matrix, size,
+                                    CV_32FC1, expected_x, expected_y);
+        camera_ns::build_undistort_maps(camera_matrix, coeffs[i], new_camera_matrix, size, CV_32FC1,
+                                        map_x, map_y);
+        EXPECT_LT(cv::norm(expected_x, map_x, cv::NORM_INF), 1e-3) << "model " << i;
+        EXPECT_LT(cv::norm(expected_y, map_y, cv::NORM_INF), 1e-3) << "model " << i;
+
+        cv::Mat expected1, expected2, map1, map2;
+        cv::initUndistortRectifyMap(camera_matrix, coeffs[i], cv::Mat(), new_camera_matrix, size,
+                                    CV_16SC2, expected1, expected2);
+        camera_ns::build_undistort_maps(camera_matrix, coeffs[i], new_camera_matrix, size, CV_16SC2,
+                                        map1, map2);
+        ASSERT_EQ(CV_16SC2, map1.type());
+        ASSERT_EQ(CV_16UC1, map2.type());
+        /// fixed-point values may differ by rounding of a single 1/32 px step
+        int max_difference = 0;
+        for (int y = 0; y < size.height; ++y) {
+            for (int x = 0; x < size.width; ++x) {
+                const int ex = expected1.at<cv::Vec2s>(y, x)[0] * 32 + (expected2.at<ushort>(y, x) & 31);
+                const int ey = expected1.at<cv::Vec2s>(y, x)[1] * 32 + (expected2.at<ushort>(y, x) >> 5);
+                const int ax = map1.at<cv::Vec2s>(y, x)[0] * 32 + (map2.at<ushort>(y, x) & 31);
+                const int ay = map1.at<cv::Vec2s>(y, x)[1] * 32 + (map2.at<ushort>(y, x) >> 5);
+                max_difference = std::max(max_difference, std::max(std::abs(ex - ax), std::abs(ey - ay)));
+            }
+        }
+        EXPECT_LE(max_difference, 1) << "model " << i;
+    }
+}
+
+TEST(DistortionModelTest, PointsMatchOpenCV)
+{
+    const cv::Size size(320, 240);
+    const cv::Mat camera_matrix = make_camera_matrix();
+    const cv::Mat coeffs = (cv::Mat_<double>(1, 8) << -0.25, 0.08, 0.001, -0.0005, -0.01, 0.02, -0.01, 0.005);
+    const cv::Mat new_camera_matrix = cv::getOptimalNewCameraMatrix(camera_matrix, coeffs, size, 1, size);
+
+    std::vector<cv::Point2f> points;
+    points.push_back(cv::Point2f(10.0f, 12.0f));
+    points.push_back(cv::Point2f(160.0f, 120.0f));
+    points.push_back(cv::Point2f(300.5f, 220.25f));
+    std::vector<cv::Point2f> expected, undistorted;
+    cv::undistortPoints(points, expected, camera_matrix, coeffs, cv::noArray(), new_camera_matrix);
+    camera_ns::undistort_image_points(points, undistorted, camera_matrix, coeffs, new_camera_matrix);
+    ASSERT_EQ(expected.size(), undistorted.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i].x, undistorted[i].x, 1e-3);
+        EXPECT_NEAR(expected[i].y, undistorted[i].y, 1e-3);
+    }
+
+    std::vector<cv::Point2d> normalized(1, cv::Point2d(-0.3, 0.2));
+    std::vector<cv::Point3d> object_points(1, cv::Point3d(-0.3, 0.2, 1.0));
+    std::vector<cv::Point2f> projected, image_points;
+    cv::projectPoints(object_points, cv::Mat::zeros(3, 1, CV_64F), cv::Mat::zeros(3, 1, CV_64F),
+                      camera_matrix, coeffs, projected);
+    camera_ns::distort_normalized_points(camera_matrix, coeffs, normalized, image_points);
+    ASSERT_EQ(1u, image_points.size());
+    EXPECT_NEAR(projected[0].x, image_points[0].x, 1e-3);
+    EXPECT_NEAR(projected[0].y, image_points[0].y, 1e-3);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <opencv2/imgproc.hpp>
+#include "remap_kernels.h"
+
+static cv::Mat make_shift_map(cv::Size size, float dx, float dy)
+{
+    cv::Mat map(size, CV_32FC2);
+    for (int y = 0; y < size.height; ++y) {
+        for (int x = 0; x < size.width; ++x) {
+            map.at<cv::Vec2f>(y, x) = cv::Vec2f(x + dx, y + dy);
+        }
+    }
+    return map;
+}
+
+static void expect_same_as_opencv(int type, double tolerance)
+{
+    cv::Mat src(48, 64, type);
+    cv::randu(src, 0, 255);
+    cv::Mat float_map = make_shift_map(src.size(), 0.375f, -0.625f);
+
+    cv::Mat expected;
+    cv::remap(src, expected, float_map, cv::Mat(), cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT, cv::Scalar());
+    /// kernels are called directly, remap_frame() leaves some types to cv::remap
+    cv::Mat result(src.size(), type);
+    const cv::Range all_rows(0, src.rows);
+    ASSERT_TRUE(camera_ns::remap_rows(src, result, camera_ns::FloatMapSampler(float_map, cv::Mat()),
+                                      camera_ns::RemapInterpolation::linear, all_rows));
+    EXPECT_LE(cv::norm(expected, result, cv::NORM_INF), tolerance);
+
+    cv::Mat map1, map2;
+    cv::convertMaps(float_map, cv::Mat(), map1, map2, CV_16SC2);
+    cv::remap(src, expected, map1, map2, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT, cv::Scalar());
+    ASSERT_TRUE(camera_ns::remap_rows(src, result, camera_ns::FixedPointMapSampler(map1, map2),
+                                      camera_ns::RemapInterpolation::linear, all_rows));
+    EXPECT_LE(cv::norm(expected, result, cv::NORM_INF), tolerance);
+
+    /// whole frame, by the kernel or by cv::remap
+    cv::Mat frame_result;
+    if (camera_ns::remap_frame(src, frame_result, map1, map2, camera_ns::RemapInterpolation::linear)) {
+        EXPECT_TRUE(camera_ns::is_dense_remap_kernel_preferred(type));
+        EXPECT_LE(cv::norm(expected, frame_result, cv::NORM_INF), tolerance);
+    } else {
+        EXPECT_FALSE(camera_ns::is_dense_remap_kernel_preferred(type));
+    }
+}
+
+TEST(RemapKernelsTest, MatchesOpenCVFor8Bit)
+{
+    expect_same_as_opencv(CV_8UC1, 1.0);
+    expect_same_as_opencv(CV_8UC3, 1.0);
+    expect_same_as_opencv(CV_8UC4, 1.0);
+}
+
+TEST(RemapKernelsTest, MatchesOpenCVFor16Bit)
+{
+    expect_same_as_opencv(CV_16UC1, 1.0);
+    expect_same_as_opencv(CV_16UC3, 1.0);
+    expect_same_as_opencv(CV_16UC4, 1.0);
+}
+
+TEST(RemapKernelsTest, MatchesOpenCVForFloat)
+{
+    expect_same_as_opencv(CV_32FC1, 0.5);
+    expect_same_as_opencv(CV_32FC3, 0.5);
+    expect_same_as_opencv(CV_32FC4, 0.5);
+}
+
+TEST(RemapKernelsTest, DenseMapsAreLeftToOpenCV)
+{
+    EXPECT_FALSE(camera_ns::is_dense_remap_kernel_preferred(CV_8UC1));
+    EXPECT_FALSE(camera_ns::is_dense_remap_kernel_preferred(CV_8UC3));
+    EXPECT_FALSE(camera_ns::is_dense_remap_kernel_preferred(CV_16UC3));
+    EXPECT_FALSE(camera_ns::is_dense_remap_kernel_preferred(CV_32FC3));
+    cv::Mat src(8, 8, CV_16UC3, cv::Scalar::all(1));
+    cv::Mat map1, map2, dst;
+    cv::convertMaps(make_shift_map(src.size(), 0.5f, 0.5f), cv::Mat(), map1, map2, CV_16SC2);
+    EXPECT_FALSE(camera_ns::remap_frame(src, dst, map1, map2, camera_ns::RemapInterpolation::linear));
+}
+
+TEST(RemapKernelsTest, BandMatchesWholeFrame)
+{
+    const int types[] = {CV_8UC3, CV_16UC1, CV_32FC3, CV_64FC1};
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        cv::Mat src(48, 64, types[t]);
+        cv::randu(src, 0, 255);
+        cv::Mat map1, map2;
+        cv::convertMaps(make_shift_map(src.size(), 0.375f, -0.625f), cv::Mat(), map1, map2, CV_16SC2);
+        cv::Mat whole(src.size(), src.type(), cv::Scalar::all(0));
+        cv::Mat banded(src.size(), src.type(), cv::Scalar::all(0));
+        camera_ns::remap_band(src, whole, map1, map2, camera_ns::RemapInterpolation::linear,
+                              cv::Range(0, src.rows));
+        for (int row = 0; row < src.rows; row += 16) {
+            camera_ns::remap_band(src, banded, map1, map2, camera_ns::RemapInterpolation::linear,
+                                  cv::Range(row, std::min(row + 16, src.rows)));
+        }
+        EXPECT_EQ(0.0, cv::norm(whole, banded, cv::NORM_INF)) << "type " << types[t];
+    }
+}
+
+TEST(RemapKernelsTest, BandOutsideSourceIsBorder)
+{
+    const int types[] = {CV_8UC1, CV_16UC3, CV_64FC1};
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        cv::Mat src(48, 64, types[t]);
+        cv::randu(src, 1, 255);
+        cv::Mat map1, map2;
+        /// the top band samples only above the source frame
+        cv::convertMaps(make_shift_map(src.size(), 0.5f, -20.0f), cv::Mat(), map1, map2, CV_16SC2);
+        camera_ns::SourceRowIndex index;
+        camera_ns::build_source_row_index(camera_ns::FixedPointMapSampler(map1, map2), src.rows, 16,
+                                          camera_ns::RemapInterpolation::linear, index);
+        ASSERT_EQ(3u, index.source_rows.size());
+        EXPECT_TRUE(index.source_rows[0].empty());
+
+        cv::Mat expected;
+        cv::remap(src, expected, map1, map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar());
+        cv::Mat banded(src.size(), src.type(), cv::Scalar::all(7));
+        for (int row = 0; row < src.rows; row += 16) {
+            camera_ns::remap_band(src, banded, map1, map2, camera_ns::RemapInterpolation::linear,
+                                  cv::Range(row, row + 16));
+        }
+        EXPECT_EQ(0.0, cv::norm(banded.rowRange(0, 16), cv::NORM_INF)) << "type " << types[t];
+        EXPECT_LE(cv::norm(expected, banded, cv::NORM_INF), 1.0) << "type " << types[t];
+
+        /// an empty band leaves the destination untouched
+        camera_ns::remap_band(cv::Mat(src.size(), src.type(), cv::Scalar::all(3)), banded, map1, map2,
+                              camera_ns::RemapInterpolation::linear, cv::Range(20, 20));
+        EXPECT_LE(cv::norm(expected, banded, cv::NORM_INF), 1.0) << "type " << types[t];
+    }
+}
+
+TEST(RemapKernelsTest, UnsupportedTypeFallsBack)
+{
+    cv::Mat src(8, 8, CV_64FC1, cv::Scalar(1.0));
+    cv::Mat result;
+    EXPECT_FALSE(camera_ns::remap_frame(src, result, make_shift_map(src.size(), 0, 0),
+                                        cv::Mat(), camera_ns::RemapInterpolation::linear));
+}
+
+TEST(RemapKernelsTest, SourceRowIndexCoversSampledRows)
+{
+    cv::Mat map = make_shift_map(cv::Size(8, 10), 0.0f, 2.5f);
+    camera_ns::SourceRowIndex index;
+    camera_ns::build_source_row_index(camera_ns::FloatMapSampler(map, cv::Mat()), 10, 4,
+                                      camera_ns::RemapInterpolation::linear, index);
+    EXPECT_EQ(4, index.band_rows);
+    ASSERT_EQ(3u, index.source_rows.size());
+    EXPECT_EQ(cv::Range(2, 7), index.source_rows[0]);
+    EXPECT_EQ(cv::Range(6, 10), index.source_rows[1]);
+    /// the last band samples below the source frame only
+    EXPECT_TRUE(index.source_rows[2].empty());
+}
@@ -0,0 +1,118 @@
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "shm_frame_ring.h"
+
+/**
+ * @brief: Returns a segment name unique to this test process, a segment left
+ * by an earlier crashed run of the same process id is removed
+ */
+static std::string make_ring_name(const std::string& base)
+{
+    std::string name = base + "_" + std::to_string(getpid());
+    camera_ns::ShmFramePublisher::remove(name);
+    return name;
+}
+
+TEST(ShmFrameRingTest, SubscriberMapsPublishedFrame)
+{
+    camera_ns::ShmFramePublisher publisher;
+    camera_ns::ShmFrameSubscriber subscriber;
+    const std::string name = make_ring_name("test_shm_ring");
+    EXPECT_FALSE(subscriber.open(make_ring_name("test_shm_ring_missing")));
+    ASSERT_TRUE(publisher.create(name, 2, 4 * 6 * 3));
+    ASSERT_TRUE(subscriber.open(name));
+    EXPECT_TRUE(subscriber.get_publisher_open());
+
+    camera_ns::ShmFrameView view;
+    EXPECT_FALSE(subscriber.map_latest(view));
+    EXPECT_FALSE(publisher.publish(cv::Mat(8, 8, CV_8UC3), 1));
+
+    cv::Mat frame(4, 6, CV_8UC3, cv::Scalar(1, 2, 3));
+    ASSERT_TRUE(publisher.publish(frame, 7));
+    ASSERT_TRUE(subscriber.map_latest(view));
+    EXPECT_EQ(7u, view.frame_sequence);
+    EXPECT_EQ(frame.size(), view.frame.size());
+    EXPECT_EQ(CV_8UC3, view.frame.type());
+    EXPECT_EQ(0, cv::norm(frame, view.frame, cv::NORM_INF));
+    EXPECT_TRUE(subscriber.validate(view));
+
+    /// the second frame goes to the other slot, the third one overwrites the mapped slot
+    ASSERT_TRUE(publisher.publish(cv::Mat(4, 6, CV_8UC3, cv::Scalar(4, 5, 6)), 8));
+    EXPECT_TRUE(subscriber.validate(view));
+    ASSERT_TRUE(publisher.publish(cv::Mat(4, 6, CV_8UC3, cv::Scalar(7, 8, 9)), 9));
+    EXPECT_FALSE(subscriber.validate(view));
+
+    cv::Mat copy;
+    uint64_t sequence = 0;
+    ASSERT_TRUE(subscriber.copy_latest(copy, &sequence));
+    EXPECT_EQ(9u, sequence);
+    EXPECT_EQ(7, copy.at<cv::Vec3b>(3, 5)[0]);
+    EXPECT_EQ(3u, subscriber.get_write_index());
+
+    publisher.close();
+    EXPECT_FALSE(subscriber.get_publisher_open());
+}
+
+TEST(ShmFrameRingTest, LivePublisherIsNotReplaced)
+{
+    camera_ns::ShmFramePublisher publisher;
+    camera_ns::ShmFramePublisher second_publisher;
+    camera_ns::ShmFrameSubscriber subscriber;
+    const std::string name = make_ring_name("test_shm_ring_owned");
+    ASSERT_TRUE(publisher.create(name, 2, 16));
+    EXPECT_TRUE(camera_ns::ShmFramePublisher::exists(name));
+    EXPECT_FALSE(second_publisher.create(name, 2, 16));
+    ASSERT_TRUE(subscriber.open(name));
+    EXPECT_TRUE(subscriber.get_publisher_open());
+    subscriber.close();
+
+    /// a segment left by a publisher is taken over only after an explicit remove
+    EXPECT_TRUE(camera_ns::ShmFramePublisher::remove(name));
+    EXPECT_FALSE(camera_ns::ShmFramePublisher::exists(name));
+    EXPECT_TRUE(second_publisher.create(name, 2, 16));
+    second_publisher.close();
+    EXPECT_FALSE(camera_ns::ShmFramePublisher::remove(name));
+}
+
+TEST(ShmFrameRingTest, CorruptSlotHeaderIsRejected)
+{
+    camera_ns::ShmFramePublisher publisher;
+    camera_ns::ShmFrameSubscriber subscriber;
+    const std::string name = make_ring_name("test_shm_ring_corrupt");
+    const uint32_t slot_count = 2;
+    const size_t slot_bytes = 4 * 6 * 3;
+    ASSERT_TRUE(publisher.create(name, slot_count, slot_bytes));
+    ASSERT_TRUE(subscriber.open(name));
+    ASSERT_TRUE(publisher.publish(cv::Mat(4, 6, CV_8UC3, cv::Scalar(1, 2, 3)), 1));
+    camera_ns::ShmFrameView view;
+    ASSERT_TRUE(subscriber.map_latest(view));
+
+    /// another process writes the slot header, the first frame is in slot 0 behind the ring header
+    int fd = shm_open(camera_ns::get_shm_segment_name(name).c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    struct stat segment_status;
+    ASSERT_EQ(0, fstat(fd, &segment_status));
+    const size_t size = static_cast<size_t>(segment_status.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(MAP_FAILED, mapped);
+    camera_ns::ShmSlotHeader* slot = reinterpret_cast<camera_ns::ShmSlotHeader*>(
+                static_cast<char*>(mapped) + size - slot_count * camera_ns::get_shm_slot_stride(slot_bytes));
+
+    /// rows wider than the step would read past the slot
+    slot->cols = 1000;
+    EXPECT_FALSE(subscriber.map_latest(view));
+    slot->cols = 6;
+    slot->type = -1;
+    EXPECT_FALSE(subscriber.map_latest(view));
+    slot->type = CV_8UC3;
+    slot->rows = 1000;
+    EXPECT_FALSE(subscriber.map_latest(view));
+    slot->rows = 4;
+    EXPECT_TRUE(subscriber.map_latest(view));
+    munmap(mapped, size);
+}
@@ -3,10 +3,29 @@ CONFIG += console c++11
 CONFIG -= app_bundle
 CONFIG -= qt
 
+# uncomment to build without HighGUI windows (DisplayService drops frames)
+#DEFINES += CAMERA_HEADLESS
+
 SOURCES += \
         main.cpp \
+    calibration_data.cpp \
+    calibration_model.cpp \
+    calibration_reloader.cpp \
     camera.cpp \
-    test_camera.cpp
+    coarse_remap.cpp \
+    display.cpp \
+    distortion_model.cpp \
+    frame_source.cpp \
+    remap_kernels.cpp \
+    shm_frame_ring.cpp \
+    test_calibration_data.cpp \
+    test_calibration_model.cpp \
+    test_camera.cpp \
+    test_coarse_remap.cpp \
+    test_display.cpp \
+    test_distortion_model.cpp \
+    test_remap_kernels.cpp \
+    test_shm_frame_ring.cpp
 
 INCLUDEPATH += /usr/local/include/opencv \
             /usr/src/gtest/include/gtest \
@@ -22,10 +41,20 @@ LIBS += -lopencv_features2d
 LIBS += -lopencv_calib3d
 LIBS += -lopencv_objdetect
 LIBS += -lopencv_imgcodecs
+LIBS += -lrt
 LIBS += -lgtest -L/usr/local/lib/googletest -lpthread
 
 HEADERS += \
-    camera.h
+    calibration_data.h \
+    calibration_model.h \
+    calibration_reloader.h \
+    camera.h \
+    coarse_remap.h \
+    display.h \
+    distortion_model.h \
+    frame_source.h \
+    remap_kernels.h \
+    shm_frame_ring.h
 
 DISTFILES += \
     README.md